@@ -0,0 +1,82 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <span>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include <fmt/format.h>
+
+#include "callisto_exception.h"
+
+namespace callisto {
+	// For the binary formats of the caches, the write ledger and friends, values are written in native
+	// byte order and strings are prefixed with their length as a uint64_t, formats meant to be read by
+	// other programs use writeLittleEndian instead
+	class BinaryWriter {
+	protected:
+		std::ostream& out;
+
+	public:
+		BinaryWriter(std::ostream& out) : out(out) {}
+
+		template<typename T>
+		void write(T value) {
+			static_assert(std::is_trivially_copyable_v<T>);
+			out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		template<typename T>
+		requires std::is_unsigned_v<T>
+		void writeLittleEndian(T value) {
+			std::array<char, sizeof(T)> bytes{};
+			for (size_t i{ 0 }; i != sizeof(T); ++i) {
+				bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+			}
+			writeBytes(bytes);
+		}
+
+		void writeBytes(std::span<const char> bytes) {
+			out.write(bytes.data(), bytes.size());
+		}
+
+		void writeString(std::string_view string) {
+			write<uint64_t>(string.size());
+			writeBytes(string);
+		}
+	};
+
+	class BinaryReader {
+	protected:
+		std::istream& in;
+		// what is being read, for error messages
+		const std::string name;
+
+	public:
+		BinaryReader(std::istream& in, std::string_view name) : in(in), name(name) {}
+
+		template<typename T>
+		T read() {
+			static_assert(std::is_trivially_copyable_v<T>);
+			T value{};
+			readBytes({ reinterpret_cast<char*>(&value), sizeof(T) });
+			return value;
+		}
+
+		void readBytes(std::span<char> bytes) {
+			if (!in.read(bytes.data(), bytes.size())) {
+				throw CallistoException(fmt::format("{} is truncated", name));
+			}
+		}
+
+		std::string readString() {
+			std::string string(read<uint64_t>(), '\0');
+			readBytes(string);
+			return string;
+		}
+	};
+}
@@ -14,50 +14,53 @@ namespace callisto {
 	std::shared_ptr<Insertable> Builder::descriptorToInsertable(const Descriptor& descriptor, const Configuration& config) {
 		const auto symbol{ descriptor.symbol };
 		const auto name{ descriptor.name };
+		const auto lunar_magic_cache{ config.cache_lunar_magic.getOrDefault(false) ? step_cache : nullptr };
 
 		if (symbol == Symbol::INITIAL_PATCH) {
-			return std::make_shared<InitialPatch>(config);
+			return std::make_shared<InitialPatch>(config, base_image_cache);
 		}
 		else if (symbol == Symbol::GRAPHICS) {
-			return std::make_shared<Graphics>(config);
+			return std::make_shared<Graphics>(config, rom_image, lunar_magic_cache);
 		}
 		else if (symbol == Symbol::EX_GRAPHICS) {
-			return std::make_shared<ExGraphics>(config);
+			return std::make_shared<ExGraphics>(config, rom_image, lunar_magic_cache);
 		}
 		else if (symbol == Symbol::MAP16) {
 			if (config.use_text_map16_format.getOrDefault(false)) {
-				return std::make_shared<TextMap16>(config);
+				return std::make_shared<TextMap16>(config, rom_image, lunar_magic_cache);
 			}
 			else {
-				return std::make_shared<BinaryMap16>(config);
+				return std::make_shared<BinaryMap16>(config, rom_image, lunar_magic_cache);
 			}
 		}
 		else if (symbol == Symbol::TITLE_SCREEN_MOVEMENT) {
-			return std::make_shared<TitleMoves>(config);
+			return std::make_shared<TitleMoves>(config, rom_image, lunar_magic_cache);
 		}
 		else if (symbol == Symbol::SHARED_PALETTES) {
-			return std::make_shared<SharedPalettes>(config);
+			return std::make_shared<SharedPalettes>(config, rom_image, lunar_magic_cache);
 		}
 		else if (symbol == Symbol::OVERWORLD) {
-			return std::make_shared<Overworld>(config);
+			return std::make_shared<Overworld>(config, rom_image, lunar_magic_cache, graphics_base_image);
 		}
 		else if (symbol == Symbol::TITLE_SCREEN) {
-			return std::make_shared<TitleScreen>(config);
+			return std::make_shared<TitleScreen>(config, rom_image, lunar_magic_cache, graphics_base_image);
 		}
 		else if (symbol == Symbol::CREDITS) {
-			return std::make_shared<Credits>(config);
+			return std::make_shared<Credits>(config, rom_image, lunar_magic_cache, graphics_base_image);
 		}
 		else if (symbol == Symbol::GLOBAL_EX_ANIMATION) {
-			return std::make_shared<GlobalExAnimation>(config);
+			return std::make_shared<GlobalExAnimation>(config, rom_image, lunar_magic_cache, graphics_base_image);
 		}
 		else if (symbol == Symbol::LEVELS) {
-			return std::make_shared<Levels>(config);
+			return std::make_shared<Levels>(config, rom_image, lunar_magic_cache);
 		}
 		else if (symbol == Symbol::PATCH) {
 			std::vector<fs::path> include_paths{ PathUtil::getCallistoDirectoryPath(config.project_root.getOrThrow()) };
 
 			return std::make_shared<Patch>(
 				config,
+				rom_image,
+				asar_cache,
 				name.value(),
 				include_paths
 			);
@@ -68,6 +71,8 @@ namespace callisto {
 
 			return std::make_shared<Module>(
 				config,
+				rom_image,
+				asar_cache,
 				name.value(),
 				PathUtil::getCallistoAsmFilePath(config.project_root.getOrThrow()),
 				module_addresses,
@@ -80,7 +85,9 @@ namespace callisto {
 			return std::make_shared<ExternalTool>(
 				name.value(),
 				config,
-				tool_config
+				tool_config,
+				rom_image,
+				step_cache
 			);
 		}
 		else {
@@ -97,7 +104,7 @@ namespace callisto {
 			CALLISTO_VERSION_MAJOR, CALLISTO_VERSION_MINOR, CALLISTO_VERSION_PATCH);
 
 		for (const auto& descriptor : config.build_order) {
-			report["build_order"].push_back(descriptor.toJson());
+			report["build_order"].push_back(descriptor.toJson(config.project_root.getOrThrow()));
 		}
 		
 		report["inserted_levels"] = std::vector<int>();
@@ -124,9 +131,9 @@ namespace callisto {
 		for (const auto& [input_path, module_config] : config.module_configurations) {
 			std::vector<std::string> module_outputs{};
 			for (const auto& output_path : module_config.real_output_paths.getOrThrow()) {
-				module_outputs.push_back(output_path.string());
+				module_outputs.push_back(PathUtil::toPortable(output_path, config.project_root.getOrThrow()));
 			}
-			module_output_map.insert({ input_path.string(), module_outputs });
+			module_output_map.insert({ PathUtil::toPortable(input_path, config.project_root.getOrThrow()), module_outputs });
 		}
 		report["module_outputs"] = module_output_map;
 
@@ -172,7 +179,7 @@ namespace callisto {
 
 					while (true) {
 						try {
-							fs::copy_file(source, target, fs::copy_options::overwrite_existing);
+							publishFile(source, target);
 							break;
 						}
 						catch (const std::runtime_error& e) {
@@ -211,6 +218,16 @@ namespace callisto {
 		}
 	}
 	
+	void Builder::publishFile(const fs::path& source, const fs::path& target) {
+		// a rename replaces the output in one go, but only works if the temporary folder is on
+		// the same file system, which it isn't when it lives in memory, so copy in that case
+		std::error_code error{};
+		fs::rename(source, target, error);
+		if (error) {
+			fs::copy_file(source, target, fs::copy_options::overwrite_existing);
+		}
+	}
+
 	void Builder::init(const Configuration& config) {
 		module_count = 0;
 
@@ -223,6 +240,35 @@ namespace callisto {
 
 		tryConvenienceSetup(config);
 
+		const auto& project_root{ config.project_root.getOrThrow() };
+		std::optional<fs::path> shared_step_cache{};
+		std::optional<fs::path> shared_build_cache{};
+		if (config.cache_shared_directory.isSet()) {
+			shared_step_cache = PathUtil::getSharedStepCacheDirectoryPath(config.cache_shared_directory.getOrThrow());
+			shared_build_cache = PathUtil::getSharedBuildCacheDirectoryPath(config.cache_shared_directory.getOrThrow());
+		}
+
+		// asar results and other steps' results live in the same store, so they share a size limit
+		const auto step_cache_size{ static_cast<uintmax_t>(config.step_cache_size.getOrDefault(DEFAULT_STEP_CACHE_SIZE_MB)) * 1024 * 1024 };
+		if (config.cache_assembly.getOrDefault(false)) {
+			asar_cache = std::make_shared<AsarCache>(PathUtil::getStepCacheDirectoryPath(project_root), project_root,
+				shared_step_cache);
+		}
+		// which steps get to use this depends on their own settings, see descriptorToInsertable
+		step_cache = std::make_shared<StepCache>(PathUtil::getStepCacheDirectoryPath(project_root), project_root,
+			step_cache_size, shared_step_cache);
+		if (config.cache_builds.getOrDefault(false)) {
+			build_cache = std::make_shared<BuildCache>(PathUtil::getBuildCacheDirectoryPath(project_root), project_root,
+				static_cast<uintmax_t>(config.build_cache_size.getOrDefault(DEFAULT_BUILD_CACHE_SIZE_MB)) * 1024 * 1024,
+				shared_build_cache);
+		}
+		base_image_cache = std::make_shared<BaseImageCache>(PathUtil::getBaseImageCacheDirectoryPath());
+		graphics_base_image = std::make_shared<GraphicsBaseImage>(config, base_image_cache);
+		// the journal refers to checkpoints, so keeping one needs them too, see Rebuilder::build for --resume
+		if (config.cache_checkpoints.getOrDefault(false) || config.cache_journal.getOrDefault(false)) {
+			initCheckpointStore(config);
+		}
+
 		if (config.levels.isSet() && fs::exists(config.levels.getOrThrow())) {
 			spdlog::info(fmt::format(colors::CALLISTO, "Ensuring normalized level filenames"));
 			spdlog::info("");
@@ -230,6 +276,23 @@ namespace callisto {
 		}
 	}
 
+	void Builder::initCheckpointStore(const Configuration& config) {
+		checkpoint_store = std::make_shared<CheckpointStore>(PathUtil::getCheckpointDirectoryPath(config.project_root.getOrThrow()),
+			static_cast<uintmax_t>(config.checkpoint_cache_size.getOrDefault(DEFAULT_CHECKPOINT_CACHE_SIZE_MB)) * 1024 * 1024);
+	}
+
+	void Builder::evictStepCache() const {
+		if (step_cache == nullptr) {
+			return;
+		}
+		try {
+			step_cache->evict();
+		}
+		catch (const std::exception& e) {
+			spdlog::warn(fmt::format(colors::WARNING, "Failed to clean up cached step results with following exception:\n\r{}", e.what()));
+		}
+	}
+
 	void Builder::tryConvenienceSetup(const Configuration& config) {
 		if (!config.allow_user_input || !config.clean_rom.isSet() || 
 			!fs::exists(config.clean_rom.getOrThrow()) || fs::exists(config.output_rom.getOrThrow())) {
@@ -277,7 +340,7 @@ namespace callisto {
 		fs::copy(config.clean_rom.getOrThrow(), temp_rom_path, fs::copy_options::overwrite_existing);
 
 		if (config.initial_patch.isSet()) {
-			InitialPatch init_patch{ config };
+			InitialPatch init_patch{ config, std::make_shared<BaseImageCache>(PathUtil::getBaseImageCacheDirectoryPath()) };
 			init_patch.insert(temp_rom_path);
 		}
 
@@ -435,6 +498,19 @@ namespace callisto {
 			spdlog::warn(fmt::format(colors::WARNING, "Your clean ROM at '{}' does not have a .smc extension", clean_rom_path.string()));
 		}
 
+		// hashing is a lot quicker than summing the ROM byte by byte, so only new clean ROMs get checked
+		const BaseImageCache verified_roms{ PathUtil::getBaseImageCacheDirectoryPath() };
+		std::optional<Hasher::Hash> rom_hash{};
+		try {
+			rom_hash = Hasher::hashFile(clean_rom_path);
+			if (verified_roms.isVerifiedCleanRom(rom_hash.value())) {
+				return;
+			}
+		}
+		catch (const std::exception& e) {
+			spdlog::debug("Failed to look up clean ROM verification: {}", e.what());
+		}
+
 		const auto rom_size{ fs::file_size(clean_rom_path) };		
 		if (rom_size != CLEAN_ROM_SIZE && rom_size != CLEAN_ROM_SIZE + HEADER_SIZE) {
 			spdlog::warn(fmt::format(colors::WARNING, 
@@ -466,8 +542,10 @@ namespace callisto {
 		rom_file.read(&high_complement, 1);
 		const auto complement{ static_cast<unsigned char>(low_complement) | static_cast<unsigned char>(high_complement) << 8 };
 
+		bool clean{ true };
 		if (checksum != CLEAN_ROM_CHECKSUM || complement != CLEAN_ROM_CHECKSUM_COMPLEMENT) {
 			spdlog::warn("Your clean ROM at '{}' is not actually clean, as it has an incorrect checksum", clean_rom_path.string());
+			clean = false;
 		}
 
 		const auto rom_start{ rom_size == CLEAN_ROM_SIZE + HEADER_SIZE ? HEADER_SIZE : 0x0 };
@@ -492,6 +570,17 @@ namespace callisto {
 
 		if (sum != checksum) {
 			spdlog::warn("Your clean ROM at '{}' is not actually clean, as its checksum differs from the sum of its bytes", clean_rom_path.string());
+			clean = false;
+		}
+
+		// ROMs that aren't clean keep getting warned about
+		if (clean && rom_hash.has_value()) {
+			try {
+				verified_roms.markVerifiedCleanRom(rom_hash.value());
+			}
+			catch (const std::exception& e) {
+				spdlog::debug("Failed to remember clean ROM verification: {}", e.what());
+			}
 		}
 	}
 
@@ -522,4 +611,441 @@ namespace callisto {
 				"following exception, Update may behave erroneously:\n\r{}");
 		}
 	}
+
+	void Builder::reportConflicts(std::shared_ptr<WriteLedger> write_ledger, const std::optional<fs::path>& log_file_path,
+		ConflictWriter::Format log_format, Conflicts conflict_policy, std::exception_ptr conflict_exception,
+		const std::unordered_set<Descriptor>& ignored_descriptors, const fs::path& project_root, RomView::Mapper rom_mapper) {
+		if (conflict_policy == Conflicts::NONE) {
+			spdlog::info(fmt::format(colors::NOTIFICATION, "Not set to detect conflicts"));
+			return;
+		}
+
+		if (conflict_exception != nullptr) {
+			try {
+				std::rethrow_exception(conflict_exception);
+			}
+			catch (const std::exception& e) {
+				spdlog::warn(fmt::format(colors::WARNING, "The following exception prevented conflict detection:\n\r{}", e.what()));
+				return;
+			}
+		}
+
+		std::unordered_set<WriteLedger::WriterId> ignored_writers{};
+		for (const auto& descriptor : ignored_descriptors) {
+			ignored_writers.insert(write_ledger->internWriter(descriptor.toString(project_root)));
+		}
+
+		std::optional<ConflictWriter> conflict_writer{};
+		if (log_file_path.has_value()) {
+			conflict_writer.emplace(log_file_path.value(), log_format);
+		}
+		int conflicts{ 0 };
+
+		int conflict_start{ 0 };
+		int conflict_size{ 0 };
+		WriterIds conflict_writers{};
+		ConflictVector written_bytes{};
+
+		const auto finish_conflict{ [&] {
+			if (conflict_size == 0) {
+				return;
+			}
+
+			const ConflictWriter::Conflict conflict{ conflict_start, RomView::pcToSnes(conflict_start, rom_mapper).value_or(-1), conflict_size, written_bytes };
+			++conflicts;
+			if (conflict_writer.has_value()) {
+				conflict_writer.value().write(conflict);
+			}
+			else {
+				spdlog::warn(ConflictWriter::toText(conflict, true));
+			}
+			conflict_size = 0;
+		} };
+
+		for (const auto& segment : write_ledger->getSegments()) {
+			if (segmentIsIdentical(*write_ledger, segment, ignored_writers)) {
+				finish_conflict();
+				continue;
+			}
+
+			const auto writers{ getWriters(*write_ledger, segment) };
+			for (int pc_offset{ segment.start }; pc_offset != segment.end; ++pc_offset) {
+				if (writesAreIdentical(*write_ledger, segment.runs, pc_offset, ignored_writers)) {
+					finish_conflict();
+					continue;
+				}
+
+				if (conflict_size != 0 && writers != conflict_writers) {
+					finish_conflict();
+				}
+
+				if (conflict_size == 0) {
+					conflict_start = pc_offset;
+					conflict_writers = writers;
+					written_bytes.clear();
+					for (const auto writer : writers) {
+						written_bytes.push_back({ write_ledger->getWriterName(writer), {} });
+					}
+				}
+
+				for (size_t i{ 0 }; i != segment.runs.size(); ++i) {
+					written_bytes.at(i).second.push_back(write_ledger->getByte(segment.runs[i], pc_offset));
+				}
+				++conflict_size;
+			}
+		}
+		finish_conflict();
+
+		if (conflict_writer.has_value()) {
+			conflict_writer.value().finish();
+		}
+		
+		if (conflicts == 0) {
+			spdlog::info(fmt::format(colors::PARTIAL_SUCCESS, "No conflicts found"));
+		}
+		else if (conflict_writer.has_value()) {
+			spdlog::warn(fmt::format(colors::WARNING, "{} conflict(s) logged to {}", 
+				conflicts, log_file_path.value().string()));
+		}
+	}
+
+	bool Builder::writesAreIdentical(const WriteLedger& write_ledger, const std::vector<size_t>& runs, int pc_offset,
+		const std::unordered_set<WriteLedger::WriterId>& ignored_writers) {
+		if (runs.size() == 1) {
+			return true;
+		}
+		std::optional<unsigned char> byte_to_match{};
+		for (auto it{ runs.begin() + 1 }; it != runs.end(); ++it) {
+			if (ignored_writers.contains(write_ledger.getRun(*it).writer)) {
+				continue;
+			}
+
+			const auto byte{ write_ledger.getByte(*it, pc_offset) };
+			if (!byte_to_match.has_value()) {
+				byte_to_match = byte;
+			}
+			else if (byte_to_match.value() != byte) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool Builder::segmentIsIdentical(const WriteLedger& write_ledger, const WriteLedger::Segment& segment,
+		const std::unordered_set<WriteLedger::WriterId>& ignored_writers) {
+		if (segment.runs.size() == 1) {
+			return true;
+		}
+		const auto length{ static_cast<size_t>(segment.end - segment.start) };
+		std::optional<size_t> run_to_match{};
+		for (auto it{ segment.runs.begin() + 1 }; it != segment.runs.end(); ++it) {
+			if (ignored_writers.contains(write_ledger.getRun(*it).writer)) {
+				continue;
+			}
+
+			if (!run_to_match.has_value()) {
+				run_to_match = *it;
+			}
+			else if (std::memcmp(write_ledger.getBytes(run_to_match.value(), segment.start),
+				write_ledger.getBytes(*it, segment.start), length) != 0) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	Builder::WriterIds Builder::getWriters(const WriteLedger& write_ledger, const WriteLedger::Segment& segment) {
+		WriterIds writers{};
+		for (const auto run_index : segment.runs) {
+			writers.push_back(write_ledger.getRun(run_index).writer);
+		}
+		return writers;
+	}
+
+	ConflictWriter::Format Builder::determineConflictLogFormat(const Configuration& config) {
+		return ConflictWriter::parseFormat(config.conflict_log_format.getOrDefault("text"));
+	}
+
+	Builder::Conflicts Builder::determineConflictCheckSetting(const Configuration& config) {
+		const auto setting{ config.check_conflicts.getOrDefault("hijacks") };
+		if (setting == "all") {
+			return Conflicts::ALL;
+		}
+		else if (setting == "hijacks") {
+			return Conflicts::HIJACKS;
+		}
+		else if (setting == "none") {
+			return Conflicts::NONE;
+		}
+		else {
+			throw CallistoException(fmt::format(
+				"Unknown settings.check_conflicts setting '{}'",
+				setting
+			));
+		}
+	}
+
+	std::vector<RomDiff::Range> Builder::getChangedRanges(const std::vector<char>& old_rom, const std::vector<char>& new_rom,
+		Conflicts conflict_policy) {
+		return excludeUncheckedRanges(RomDiff::changedRanges(old_rom, new_rom), conflict_policy);
+	}
+
+	std::vector<RomDiff::Range> Builder::excludeUncheckedRanges(const std::vector<RomDiff::Range>& ranges, Conflicts conflict_policy) {
+		// skip checksum and inverse checksum
+		auto checked{ RomDiff::excludeRange(ranges, CHECKSUM_COMPLEMENT_LOCATION, CHECKSUM_LOCATION + 2) };
+
+		if (conflict_policy == Conflicts::HIJACKS) {
+			checked = RomDiff::excludeRange(checked, CLEAN_ROM_SIZE, SIZE_MAX);
+		}
+
+		return checked;
+	}
+
+	OwnershipIndex Builder::writeWriteLedger(const fs::path& project_root, const WriteLedger& write_ledger, Conflicts conflict_policy) {
+		std::ofstream ledger_file{ PathUtil::getWriteLedgerPath(project_root), std::ios::out | std::ios::binary };
+		ledger_file.put(static_cast<char>(conflict_policy));
+		write_ledger.serialize(ledger_file);
+		ledger_file.close();
+
+		// derived from the ledger, so it's kept in lockstep with it
+		const OwnershipIndex ownership_index{ write_ledger };
+		std::ofstream index_file{ PathUtil::getOwnershipIndexPath(project_root), std::ios::out | std::ios::binary };
+		ownership_index.serialize(index_file);
+		index_file.close();
+
+		return ownership_index;
+	}
+
+	std::shared_ptr<WriteLedger> Builder::readWriteLedger(const fs::path& project_root, Conflicts conflict_policy) {
+		const auto ledger_path{ PathUtil::getWriteLedgerPath(project_root) };
+		if (!fs::exists(ledger_path)) {
+			return nullptr;
+		}
+
+		std::ifstream ledger_file{ ledger_path, std::ios::in | std::ios::binary };
+
+		// a ledger that only covers hijacks is of no use when checking all conflicts and vice versa
+		if (ledger_file.get() != static_cast<int>(conflict_policy)) {
+			return nullptr;
+		}
+
+		try {
+			return std::make_shared<WriteLedger>(WriteLedger::deserialize(ledger_file));
+		}
+		catch (const CallistoException& e) {
+			spdlog::debug("Failed to read write ledger with following exception:\n\r{}", e.what());
+			return nullptr;
+		}
+	}
+
+	Hasher::Hash Builder::identifyBuild(const Configuration& config) {
+		Hasher hasher{};
+		hasher.updateString(fmt::format("{}.{}.{}", CALLISTO_VERSION_MAJOR, CALLISTO_VERSION_MINOR, CALLISTO_VERSION_PATCH));
+		hasher.updateString(config.profile_name.value_or(""));
+
+		// user wide settings live somewhere else on every machine, their contents are what counts
+		std::vector<std::pair<std::string, Hasher::Hash>> source_files{};
+		for (const auto& source_file : config.source_files) {
+			auto portable{ PathUtil::toPortable(source_file, config.project_root.getOrThrow()) };
+			if (fs::path(portable).is_absolute()) {
+				portable = source_file.filename().string();
+			}
+			source_files.push_back({ portable, Hasher::hashFile(source_file) });
+		}
+		std::sort(source_files.begin(), source_files.end());
+		hasher.updateValue(source_files.size());
+		for (const auto& [portable, hash] : source_files) {
+			hasher.updateString(portable);
+			hasher.updateValue(hash);
+		}
+
+		hasher.updateValue(Hasher::hashFile(config.clean_rom.getOrThrow()));
+		return hasher.digest();
+	}
+
+	std::vector<fs::path> Builder::readBuildReportDependencies(const fs::path& project_root) {
+		std::ifstream build_report_file{ PathUtil::getBuildReportPath(project_root) };
+		const json build_report = json::parse(build_report_file);
+
+		std::vector<fs::path> dependencies{};
+		for (const auto& block : build_report["dependencies"]) {
+			for (const auto& resource_dependency : block["resource_dependencies"]) {
+				dependencies.push_back(ResourceDependency(resource_dependency, project_root).dependent_path);
+			}
+		}
+		return dependencies;
+	}
+
+	void Builder::refreshBuildReportTimestamps(const fs::path& project_root) {
+		json build_report;
+		{
+			std::ifstream build_report_file{ PathUtil::getBuildReportPath(project_root) };
+			build_report = json::parse(build_report_file);
+		}
+
+		// the contents are the same as when the report was written, but checking out a branch changes
+		// write times, which would otherwise make Update reinsert everything
+		for (auto& block : build_report["dependencies"]) {
+			for (auto& resource_dependency : block["resource_dependencies"]) {
+				const ResourceDependency refreshed{ ResourceDependency(resource_dependency, project_root).dependent_path,
+					resource_dependency["policy"].get<Policy>() };
+				resource_dependency = refreshed.toJson(project_root);
+			}
+		}
+
+		writeBuildReport(project_root, build_report);
+	}
+
+	BuildCache::Artifacts Builder::collectBuildArtifacts(const Configuration& config) {
+		const auto& project_root{ config.project_root.getOrThrow() };
+		BuildCache::Artifacts artifacts{};
+
+		const auto read_file{ [](const fs::path& path) {
+			std::ifstream file{ path, std::ios::in | std::ios::binary };
+			return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		} };
+		const auto add_project_file{ [&](const fs::path& path) {
+			if (fs::is_regular_file(path)) {
+				artifacts.project_files.push_back({ path.lexically_relative(project_root), read_file(path) });
+			}
+		} };
+
+		for (const auto& directory : { PathUtil::getUserModuleDirectoryPath(project_root),
+			PathUtil::getModuleCacheDirectoryPath(project_root) }) {
+			artifacts.directories.push_back(directory.lexically_relative(project_root));
+			if (fs::exists(directory)) {
+				for (const auto& entry : fs::recursive_directory_iterator(directory)) {
+					add_project_file(entry.path());
+				}
+			}
+		}
+
+		for (const auto& path : { PathUtil::getBuildReportPath(project_root), PathUtil::getWriteLedgerPath(project_root),
+			PathUtil::getOwnershipIndexPath(project_root), PathUtil::getFreespaceIndexPath(project_root) }) {
+			add_project_file(path);
+		}
+
+		for (const auto& [_, module_config] : config.module_configurations) {
+			for (const auto& output_path : module_config.real_output_paths.getOrDefault({})) {
+				add_project_file(output_path);
+			}
+		}
+
+		// same files moveTempToOutput picks up
+		const auto temporary_rom_name{ PathUtil::getTemporaryRomPath(config.temporary_folder.getOrThrow(),
+			config.output_rom.getOrThrow()).stem().string() };
+		for (const auto& entry : fs::directory_iterator(config.temporary_folder.getOrThrow())) {
+			if (fs::is_regular_file(entry) && entry.path().stem().string().starts_with(temporary_rom_name)) {
+				artifacts.rom_files.push_back({ entry.path().filename(), read_file(entry.path()) });
+			}
+		}
+
+		return artifacts;
+	}
+
+	void Builder::restoreBuildArtifacts(const Configuration& config, const BuildCache::Artifacts& artifacts) {
+		const auto& project_root{ config.project_root.getOrThrow() };
+
+		const auto write_file{ [](const fs::path& path, const std::string& contents) {
+			fs::create_directories(path.parent_path());
+			std::ofstream file{ path, std::ios::out | std::ios::binary };
+			file.write(contents.data(), contents.size());
+			if (!file) {
+				throw CallistoException(fmt::format(colors::EXCEPTION, "Failed to restore cached file '{}'", path.string()));
+			}
+		} };
+
+		for (const auto& directory : artifacts.directories) {
+			fs::remove_all(project_root / directory);
+		}
+		// these only exist for some builds, so one from a previous build mustn't stick around
+		removeWriteLedger(project_root);
+		fs::remove(PathUtil::getFreespaceIndexPath(project_root));
+
+		for (const auto& [path, contents] : artifacts.project_files) {
+			write_file(project_root / path, contents);
+		}
+		for (const auto& [name, contents] : artifacts.rom_files) {
+			write_file(config.temporary_folder.getOrThrow() / name, contents);
+		}
+
+		refreshBuildReportTimestamps(project_root);
+	}
+
+	void Builder::removeWriteLedger(const fs::path& project_root) {
+		for (const auto& path : { PathUtil::getWriteLedgerPath(project_root), PathUtil::getOwnershipIndexPath(project_root) }) {
+			if (fs::exists(path)) {
+				fs::remove(path);
+			}
+		}
+	}
+
+	OwnershipIndex Builder::readOwnershipIndex(const fs::path& project_root) {
+		const auto index_path{ PathUtil::getOwnershipIndexPath(project_root) };
+		if (!fs::exists(index_path)) {
+			throw NotFoundException(fmt::format(
+				colors::EXCEPTION,
+				"No ownership index found at '{}', rebuild with settings.check_conflicts enabled to create it",
+				index_path.string()
+			));
+		}
+
+		std::ifstream index_file{ index_path, std::ios::in | std::ios::binary };
+		return OwnershipIndex::deserialize(index_file);
+	}
+
+	void Builder::writeFreespaceIndex(const fs::path& project_root, std::span<const char> rom, const OwnershipIndex* ownership_index) {
+		try {
+			FreespaceIndex index{ rom, RomView::detectMapper(rom) };
+
+			// modules know exactly which of their labels sit in which freespace block
+			const auto cleanup_directory{ PathUtil::getModuleCleanupDirectoryPath(project_root) };
+			if (fs::exists(cleanup_directory)) {
+				for (const auto& entry : fs::recursive_directory_iterator(cleanup_directory)) {
+					if (!entry.is_regular_file() || entry.path().extension() != ".addr") {
+						continue;
+					}
+
+					const auto relative{ fs::relative(entry.path(), cleanup_directory) };
+					const auto owner{ (relative.parent_path() / relative.stem()).generic_string() };
+
+					std::ifstream addresses{ entry.path() };
+					std::string line;
+					while (std::getline(addresses, line)) {
+						index.assignOwner(std::stoi(line), owner);
+					}
+				}
+			}
+
+			if (ownership_index != nullptr) {
+				index.assignOwners(*ownership_index);
+			}
+
+			std::ofstream index_file{ PathUtil::getFreespaceIndexPath(project_root) };
+			index_file << std::setw(4) << index.toJson() << std::endl;
+			index_file.close();
+
+			spdlog::debug("Freespace index written, 0x{:X} bytes free in {} RATS protected blocks, largest free run is 0x{:X} bytes",
+				index.getFreeBytes(), index.getBlocks().size(), index.getLargestFreeRun());
+		}
+		catch (const std::exception& e) {
+			spdlog::warn(fmt::format(colors::WARNING, "Failed to write freespace index with following exception:\n\r{}", e.what()));
+		}
+	}
+
+	FreespaceIndex Builder::readFreespaceIndex(const fs::path& project_root) {
+		const auto index_path{ PathUtil::getFreespaceIndexPath(project_root) };
+		if (!fs::exists(index_path)) {
+			throw NotFoundException(fmt::format(
+				colors::EXCEPTION,
+				"No freespace index found at '{}', build your ROM to create it",
+				index_path.string()
+			));
+		}
+
+		std::ifstream index_file{ index_path };
+		return FreespaceIndex::fromJson(json::parse(index_file));
+	}
 }
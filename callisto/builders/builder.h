@@ -1,6 +1,8 @@
 #pragma once
 
 #include <memory>
+#include <sstream>
+#include <cstring>
 
 #include <nlohmann/json.hpp>
 
@@ -27,6 +29,18 @@
 #include "../insertable.h"
 #include "../saver/saver.h"
 #include "../descriptor.h"
+#include "../conflicts/write_ledger.h"
+#include "../conflicts/ownership_index.h"
+#include "../conflicts/conflict_writer.h"
+#include "../rom/rom_diff.h"
+#include "../rom/rom_image.h"
+#include "../rom/rom_view.h"
+#include "../rom/freespace_index.h"
+#include "../cache/asar_cache.h"
+#include "../cache/step_cache.h"
+#include "../cache/build_cache.h"
+#include "../cache/checkpoint_store.h"
+#include "../cache/base_image_cache.h"
 
 #include "../time_util.h"
 #include "../prompt_util.h"
@@ -36,7 +50,7 @@ using json = nlohmann::json;
 namespace callisto {
 	class Builder {
 	protected:
-		static constexpr auto BUILD_REPORT_VERSION{ 1 };
+		static constexpr auto BUILD_REPORT_VERSION{ 2 };
 
 		static constexpr auto DEFINE_PREFIX{ "CALLISTO" };
 		static constexpr auto VERSION_DEFINE_NAME{ "VERSION" };
@@ -54,15 +68,36 @@ namespace callisto {
 		static constexpr auto CHECKSUM_COMPLEMENT_LOCATION{ 0x7FDC };
 		static constexpr auto CLEAN_ROM_CHECKSUM_COMPLEMENT{ CLEAN_ROM_CHECKSUM ^ 0xFFFF };
 
+		static constexpr auto DEFAULT_STEP_CACHE_SIZE_MB{ 1024 };
+		static constexpr auto DEFAULT_BUILD_CACHE_SIZE_MB{ 1024 };
+		static constexpr auto DEFAULT_CHECKPOINT_CACHE_SIZE_MB{ 1024 };
+
 		static constexpr auto CLEAN_ROM_SIZE{ 0x80000 };
 		static constexpr auto HEADER_SIZE{ 0x200 };
 
 		using Insertables = std::vector<std::pair<Descriptor, std::shared_ptr<Insertable>>>;
 		using DependencyVector = std::vector<std::pair<Descriptor, std::pair<std::unordered_set<ResourceDependency>,
 			std::unordered_set<ConfigurationDependency>>>>;
+		using WriterIds = std::vector<WriteLedger::WriterId>;
+		using ConflictVector = ConflictWriter::WrittenBytes;
+
+		enum class Conflicts {
+			NONE,
+			HIJACKS,
+			ALL
+		};
 
 		std::shared_ptr<std::unordered_set<int>> module_addresses{ std::make_shared<std::unordered_set<int>>() };
 		int module_count{ 0 };
+
+		// the temporary ROM, set once it has been created
+		std::shared_ptr<RomImage> rom_image{};
+		std::shared_ptr<AsarCache> asar_cache{};
+		std::shared_ptr<StepCache> step_cache{};
+		std::shared_ptr<BuildCache> build_cache{};
+		std::shared_ptr<CheckpointStore> checkpoint_store{};
+		std::shared_ptr<BaseImageCache> base_image_cache{};
+		std::shared_ptr<GraphicsBaseImage> graphics_base_image{};
 	
 		Insertables buildOrderToInsertables(const Configuration& config);
 		std::shared_ptr<Insertable> descriptorToInsertable(const Descriptor& descriptor, const Configuration& config);
@@ -72,8 +107,11 @@ namespace callisto {
 
 		static void cacheModules(const fs::path& project_root);
 		static void moveTempToOutput(const Configuration& config);
+		static void publishFile(const fs::path& source, const fs::path& target);
 
 		void init(const Configuration& config);
+		void initCheckpointStore(const Configuration& config);
+		void evictStepCache() const;
 		static void ensureCacheStructure(const Configuration& config);
 		static void generateCallistoAsmFile(const Configuration& config);
 
@@ -91,5 +129,37 @@ namespace callisto {
 		static void writeIfDifferent(const std::string& str, const fs::path& out_file);
 
 		static void removeBuildReport(const fs::path& project_root);
+
+		static void reportConflicts(std::shared_ptr<WriteLedger> write_ledger, const std::optional<fs::path>& log_file_path,
+			ConflictWriter::Format log_format, Conflicts conflict_policy, std::exception_ptr conflict_exception,
+			const std::unordered_set<Descriptor>& ignored_descriptors, const fs::path& project_root, RomView::Mapper rom_mapper);
+		static bool writesAreIdentical(const WriteLedger& write_ledger, const std::vector<size_t>& runs, int pc_offset,
+			const std::unordered_set<WriteLedger::WriterId>& ignored_writers);
+		static bool segmentIsIdentical(const WriteLedger& write_ledger, const WriteLedger::Segment& segment,
+			const std::unordered_set<WriteLedger::WriterId>& ignored_writers);
+		static WriterIds getWriters(const WriteLedger& write_ledger, const WriteLedger::Segment& segment);
+		static std::vector<RomDiff::Range> getChangedRanges(const std::vector<char>& old_rom, const std::vector<char>& new_rom,
+			Conflicts conflict_policy);
+		static std::vector<RomDiff::Range> excludeUncheckedRanges(const std::vector<RomDiff::Range>& ranges, Conflicts conflict_policy);
+		static Conflicts determineConflictCheckSetting(const Configuration& config);
+		static ConflictWriter::Format determineConflictLogFormat(const Configuration& config);
+
+		// Also writes the ownership index derived from the ledger and returns it
+		static OwnershipIndex writeWriteLedger(const fs::path& project_root, const WriteLedger& write_ledger, Conflicts conflict_policy);
+		static std::shared_ptr<WriteLedger> readWriteLedger(const fs::path& project_root, Conflicts conflict_policy);
+		static void removeWriteLedger(const fs::path& project_root);
+
+		static void writeFreespaceIndex(const fs::path& project_root, std::span<const char> rom, const OwnershipIndex* ownership_index);
+
+		static Hasher::Hash identifyBuild(const Configuration& config);
+		static std::vector<fs::path> readBuildReportDependencies(const fs::path& project_root);
+		static void refreshBuildReportTimestamps(const fs::path& project_root);
+		static BuildCache::Artifacts collectBuildArtifacts(const Configuration& config);
+		static void restoreBuildArtifacts(const Configuration& config, const BuildCache::Artifacts& artifacts);
+
+	public:
+
+		static OwnershipIndex readOwnershipIndex(const fs::path& project_root);
+		static FreespaceIndex readFreespaceIndex(const fs::path& project_root);
 	};
 }
@@ -58,13 +58,27 @@ namespace callisto {
 			config.temporary_folder.getOrThrow(), config.output_rom.getOrThrow()
 		) };
 
+		const auto check_conflicts_policy{ determineConflictCheckSetting(config) };
+		const auto conflict_log_format{ determineConflictLogFormat(config) };
+		std::shared_ptr<WriteLedger> write_ledger{};
+		if (check_conflicts_policy != Conflicts::NONE) {
+			write_ledger = readWriteLedger(config.project_root.getOrThrow(), check_conflicts_policy);
+			if (write_ledger == nullptr) {
+				spdlog::info(fmt::format(colors::NOTIFICATION, "No conflict ledger matching the current conflict check setting found, "
+					"conflicts will be checked on the next rebuild"));
+				spdlog::info("");
+			}
+		}
+		std::vector<char> pre_insertion_rom{};
+		std::vector<char> post_insertion_rom{};
+
 		bool any_work_done{ false };
 		bool anything_ran{ false };
 		std::optional<Insertable::NoDependencyReportFound> failed_dependency_report;
 		size_t i{ 0 };
 		for (auto& entry : json_dependencies) {
 			checkRebuildResourceDependencies(json_dependencies, config.project_root.getOrThrow(), i++);
-			const auto descriptor{ Descriptor(entry["descriptor"]) };
+			const auto descriptor{ Descriptor(entry["descriptor"], config.project_root.getOrThrow()) };
 			spdlog::info(fmt::format(colors::CALLISTO, "--- {} ---", descriptor.toString(config.project_root.getOrThrow())));
 
 			const auto descriptor_string{ descriptor.toString(config.project_root.getOrThrow()) };
@@ -95,7 +109,7 @@ namespace callisto {
 			}
 			else {
 				const auto resource_result{
-					checkReinsertResourceDependencies(entry["resource_dependencies"])
+					checkReinsertResourceDependencies(entry["resource_dependencies"], config.project_root.getOrThrow())
 				};
 
 				if (resource_result.has_value()) {
@@ -119,7 +133,7 @@ namespace callisto {
 						}
 					}
 
-					const auto& old_output_paths{ report["module_outputs"][descriptor.name.value()] };
+					const auto old_output_paths{ readOldModuleOutputs(descriptor.name.value(), config.project_root.getOrThrow()) };
 
 					if (old_output_paths.size() != current_output_paths.size()) {
 						spdlog::info(fmt::format(
@@ -151,10 +165,16 @@ namespace callisto {
 				if (!fs::exists(temporary_rom_path)) {
 					fs::copy(config.output_rom.getOrThrow(), temporary_rom_path, fs::copy_options::overwrite_existing);
 				}
+				if (rom_image == nullptr) {
+					rom_image = std::make_shared<RomImage>(temporary_rom_path);
+				}
+				if (write_ledger != nullptr) {
+					pre_insertion_rom = rom_image->getBody();
+				}
 				if (descriptor.symbol == Symbol::MODULE) {
 					cleanModule(
 						descriptor.name.value(),
-						temporary_rom_path,
+						*rom_image,
 						config.project_root.getOrThrow()
 					);
 				}
@@ -162,6 +182,9 @@ namespace callisto {
 				auto insertable{ descriptorToInsertable(descriptor, config) };
 
 				insertable->init();
+				if (!insertable->usesRomImage()) {
+					rom_image->flush();
+				}
 				if (!failed_dependency_report.has_value()) {
 					std::unordered_set<ResourceDependency> resource_dependencies;
 
@@ -194,7 +217,7 @@ namespace callisto {
 							entry["configuration_dependencies"].push_back(config_dep.toJson());
 						}
 						for (const auto& resource_dep : resource_dependencies) {
-							entry["resource_dependencies"].push_back(resource_dep.toJson());
+							entry["resource_dependencies"].push_back(resource_dep.toJson(config.project_root.getOrThrow()));
 						}
 					}
 				}
@@ -217,6 +240,10 @@ namespace callisto {
 					}
 				}
 
+				if (!insertable->usesRomImage()) {
+					rom_image->reload();
+				}
+
 				if (descriptor.symbol == Symbol::PATCH) {
 					const auto& old_hijacks{ entry["hijacks"] };
 					const auto patch{ static_pointer_cast<Patch>(insertable) };
@@ -231,6 +258,15 @@ namespace callisto {
 						entry["hijacks"] = new_hijacks;
 					}
 				}
+
+				if (write_ledger != nullptr) {
+					post_insertion_rom = rom_image->getBody();
+					write_ledger->replaceWrites(
+						write_ledger->internWriter(descriptor_string),
+						getChangedRanges(pre_insertion_rom, post_insertion_rom, check_conflicts_policy),
+						pre_insertion_rom.data(), post_insertion_rom.data(), post_insertion_rom.size()
+					);
+				}
 				
 				anything_ran = true;
 				if (!any_work_done) {
@@ -247,11 +283,8 @@ namespace callisto {
 			else {
 				if (descriptor.symbol == Symbol::MODULE) {
 
-					std::vector<fs::path> old_outputs{};
-					for (const auto& entry : report["module_outputs"][descriptor.name.value()]) {
-						old_outputs.push_back(entry);
-					}
-					copyOldModuleOutput(old_outputs, descriptor.name.value(), config.project_root.getOrThrow());
+					copyOldModuleOutput(readOldModuleOutputs(descriptor.name.value(), config.project_root.getOrThrow()),
+						descriptor.name.value(), config.project_root.getOrThrow());
 					++module_count;
 				}
 
@@ -272,12 +305,39 @@ namespace callisto {
 
 			if (any_work_done) {
 				cacheModules(config.project_root.getOrThrow());
-				Saver::writeMarkerToRom(temporary_rom_path, config);
+				Saver::writeMarkerToRom(*rom_image, config);
 
 				GraphicsUtil::linkOutputRomToProjectGraphics(config, false);
 				GraphicsUtil::linkOutputRomToProjectGraphics(config, true);
 
 				moveTempToOutput(config);
+
+				std::optional<OwnershipIndex> ownership_index{};
+				try {
+					if (write_ledger != nullptr) {
+						ownership_index = writeWriteLedger(config.project_root.getOrThrow(), *write_ledger, check_conflicts_policy);
+						reportConflicts(write_ledger, config.conflict_log_file.isSet() ?
+							std::make_optional(config.conflict_log_file.getOrThrow()) : std::nullopt,
+							conflict_log_format, check_conflicts_policy, nullptr, config.ignored_conflict_symbols, config.project_root.getOrThrow(),
+							rom_image != nullptr ? RomView::detectMapper(rom_image->getBody()) : RomView::Mapper::LOROM);
+					}
+					else {
+						// whatever ledger is left over no longer matches the ROM
+						removeWriteLedger(config.project_root.getOrThrow());
+					}
+				}
+				catch (const std::exception& e) {
+					spdlog::warn(fmt::format(colors::WARNING, "The following error occurred while attempting to report conflicts:\n\r{}", e.what()));
+				}
+
+				if (rom_image != nullptr) {
+					writeFreespaceIndex(config.project_root.getOrThrow(), rom_image->getBody(),
+						ownership_index.has_value() ? &ownership_index.value() : nullptr);
+				}
+			}
+
+			if (any_work_done) {
+				evictStepCache();
 			}
 
 			try {
@@ -309,6 +369,10 @@ namespace callisto {
 					config.temporary_folder.getOrThrow().string()));
 			}
 
+			if (report_refreshed) {
+				writeBuildReport(config.project_root.getOrThrow(), report);
+			}
+
 			spdlog::info(fmt::format(colors::NOTIFICATION, "Everything already up to date, no work for me to do (-.-)"));
 			return Result::NO_WORK;
 		}
@@ -327,7 +391,7 @@ namespace callisto {
 		
 		size_t i{ 0 };
 		for (const auto& new_descriptor : config.build_order) {
-			const auto old_descriptor{ Descriptor(report["build_order"].at(i++)) };
+			const auto old_descriptor{ Descriptor(report["build_order"].at(i++), config.project_root.getOrThrow()) };
 			if (old_descriptor != new_descriptor) {
 				throw MustRebuildException(fmt::format(colors::NOTIFICATION, "Build order has changed, must rebuild"));
 			}
@@ -397,23 +461,19 @@ namespace callisto {
 		}
 	}
 
-	void QuickBuilder::checkRebuildResourceDependencies(const json& dependencies, const fs::path& project_root, size_t starting_index) const {
+	void QuickBuilder::checkRebuildResourceDependencies(json& dependencies, const fs::path& project_root, size_t starting_index) {
 		auto entry{ dependencies.begin() + starting_index };
 		while (entry != dependencies.end()) {
-			for (const auto& json_resource_dependency : (*entry)["resource_dependencies"]) {
-				const auto resource_dependency{ ResourceDependency(json_resource_dependency) };
+			for (auto& json_resource_dependency : (*entry)["resource_dependencies"]) {
+				const auto resource_dependency{ ResourceDependency(json_resource_dependency, project_root) };
 
 				if (resource_dependency.policy == Policy::REBUILD) {
-					std::optional<uint64_t> new_timestamp{
-						fs::exists(resource_dependency.dependent_path) ?
-						std::make_optional(fs::last_write_time(resource_dependency.dependent_path).time_since_epoch().count()) :
-						std::nullopt };
-					if (new_timestamp != resource_dependency.last_write_time) {
+					if (hasResourceChanged(json_resource_dependency, project_root)) {
 						throw MustRebuildException(fmt::format(
 							colors::NOTIFICATION,
 							"Dependency '{}' of '{}' has changed, must rebuild",
 							resource_dependency.dependent_path.string(),
-							Descriptor((*entry)["descriptor"]).toString(project_root)
+							Descriptor((*entry)["descriptor"], project_root).toString(project_root)
 						));
 					}
 				}
@@ -438,15 +498,11 @@ namespace callisto {
 		return {};
 	}
 
-	std::optional<ResourceDependency> QuickBuilder::checkReinsertResourceDependencies(const json& resource_dependencies) const {
-		for (const auto& entry : resource_dependencies) {
-			const auto resource_dependency{ ResourceDependency(entry) };
+	std::optional<ResourceDependency> QuickBuilder::checkReinsertResourceDependencies(json& resource_dependencies, const fs::path& project_root) {
+		for (auto& entry : resource_dependencies) {
+			const auto resource_dependency{ ResourceDependency(entry, project_root) };
 			if (resource_dependency.policy == Policy::REINSERT) {
-				std::optional<uint64_t> new_timestamp{
-					fs::exists(resource_dependency.dependent_path) ?
-					std::make_optional(fs::last_write_time(resource_dependency.dependent_path).time_since_epoch().count()) :
-					std::nullopt };
-				if (new_timestamp != resource_dependency.last_write_time) {
+				if (hasResourceChanged(entry, project_root)) {
 					return resource_dependency;
 				}
 			}
@@ -454,7 +510,39 @@ namespace callisto {
 		return {};
 	}
 
-	void QuickBuilder::cleanModule(const fs::path& module_source_path, const fs::path& temporary_rom_path, const fs::path& project_root) {
+	bool QuickBuilder::hasResourceChanged(json& json_resource_dependency, const fs::path& project_root) {
+		const ResourceDependency recorded{ json_resource_dependency, project_root };
+		if (recorded.hasSameStamp()) {
+			return false;
+		}
+
+		// git already hashed tracked files it considers unmodified, so those don't need to be read
+		const auto recorded_blob{ recorded.getContentStamp().git_blob };
+		if (recorded_blob.has_value()) {
+			const auto current_blob{ GitIndex::getCleanBlobId(recorded.dependent_path) };
+			if (current_blob.has_value()) {
+				if (current_blob != recorded_blob) {
+					return true;
+				}
+				json_resource_dependency = recorded.restamped().toJson(project_root);
+				report_refreshed = true;
+				return false;
+			}
+		}
+
+		const ResourceDependency current{ recorded.dependent_path, recorded.policy };
+		if (!recorded.hasSameContents(current)) {
+			return true;
+		}
+
+		// same contents under a new write time, e.g. after switching branches, recorded again so
+		// the next check (and the next Update) doesn't have to hash it again, keeping the blob id if that's what matched
+		json_resource_dependency = (recorded_blob.has_value() ? recorded.restamped() : current).toJson(project_root);
+		report_refreshed = true;
+		return false;
+	}
+
+	void QuickBuilder::cleanModule(const fs::path& module_source_path, RomImage& rom_image, const fs::path& project_root) {
 		const auto relative{ fs::relative(module_source_path, project_root) };
 		const auto cleanup_file{ PathUtil::getModuleCleanupCacheDirectoryPath(project_root) /
 			((relative.parent_path() / relative.stem()).string() + ".addr")
@@ -468,72 +556,42 @@ namespace callisto {
 			));
 		}
 
-		std::string patch_path{ (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path().string()).string() };
-		std::ofstream temp_patch{ patch_path };
+		const auto rom_size{ rom_image.getSize() };
+		const std::span<char> rom{ rom_image.beginPatching(), rom_size };
+		const auto rom_mapper{ RomView::detectMapper(rom) };
 
+		bool cleaned_any{ false };
 		std::ifstream module_cleanup_file{ cleanup_file };
 		std::string line;
 		while (std::getline(module_cleanup_file, line)) {
 			const auto address{ std::stoi(line) };
-			temp_patch << fmt::format("autoclean ${:06X}\n", address);
-		}
-		temp_patch.close();
-
-		std::ifstream rom_file(temporary_rom_path, std::ios::in | std::ios::binary);
-		std::vector<char> rom_bytes((std::istreambuf_iterator<char>(rom_file)), (std::istreambuf_iterator<char>()));
-		rom_file.close();
-
-		int rom_size{ static_cast<int>(rom_bytes.size()) };
-		const auto header_size{ rom_size & 0x7FFF };
-
-		int unheadered_rom_size{ rom_size - header_size };
-
-		const patchparams params{
-			sizeof(patchparams),
-			patch_path.c_str(),
-			rom_bytes.data() + header_size,
-			MAX_ROM_SIZE,
-			&unheadered_rom_size,
-			nullptr,
-			0,
-			true,
-			nullptr,
-			0,
-			nullptr,
-			nullptr,
-			nullptr,
-			0,
-			nullptr,
-			0,
-			true,
-			false
-		};
+			const auto pc_offset{ RomView::snesToPc(address, rom_mapper) };
+			if (!pc_offset.has_value()) {
+				spdlog::debug("Cleanup address ${:06X} of module {} does not map to ROM", address, module_source_path.string());
+				continue;
+			}
 
-		if (!asar_init()) {
-			throw ToolNotFoundException(fmt::format(
-				colors::EXCEPTION,
-				"Asar library file not found, did you forget to copy it alongside callisto?"
-			));
+			if (Rats::clean(rom, pc_offset.value())) {
+				cleaned_any = true;
+			}
+			else {
+				spdlog::debug("No RATS tag protecting ${:06X} of module {}", address, module_source_path.string());
+			}
 		}
 
-		const bool succeeded{ asar_patch_ex(&params) };
+		rom_image.finishPatching(static_cast<int>(rom_size), cleaned_any);
+		spdlog::debug(
+			"Successfully cleaned module {}",
+			module_source_path.string()
+		);
+	}
 
-		if (succeeded) {
-			spdlog::debug(
-				"Successfully cleaned module {}",
-				module_source_path.string()
-			);
-			std::ofstream out_rom{ temporary_rom_path, std::ios::out | std::ios::binary };
-			out_rom.write(rom_bytes.data(), rom_bytes.size());
-			out_rom.close();
-		}
-		else {
-			throw MustRebuildException(fmt::format(
-				colors::NOTIFICATION,
-				"Failed to clean module {}, must rebuild",
-				module_source_path.string()
-			));
+	std::vector<fs::path> QuickBuilder::readOldModuleOutputs(const std::string& module_source_path, const fs::path& project_root) const {
+		std::vector<fs::path> old_outputs{};
+		for (const auto& entry : report["module_outputs"][PathUtil::toPortable(module_source_path, project_root)]) {
+			old_outputs.push_back(PathUtil::fromPortable(entry.get<std::string>(), project_root));
 		}
+		return old_outputs;
 	}
 
 	void QuickBuilder::copyOldModuleOutput(const std::vector<fs::path>& module_output_paths, 
@@ -8,6 +8,8 @@
 #include "must_rebuild_exception.h"
 #include "../insertables/module.h"
 #include "../saver/saver.h"
+#include "../rom/rats.h"
+#include "../cache/git_index.h"
 
 namespace callisto {
 	class QuickBuilder : public Builder {
@@ -17,19 +19,21 @@ namespace callisto {
 			NO_WORK
 		};
 	protected:
-		static constexpr auto MAX_ROM_SIZE = 16 * 1024 * 1024;
-
 		json report;
+		// set when a dependency turned out unchanged under a new write time and got recorded again
+		bool report_refreshed{ false };
 
 		void checkBuildReportFormat() const;
 		void checkBuildOrderChange(const Configuration& config) const;
 		static void checkProblematicLevelChanges(const fs::path& levels_path, const std::unordered_set<int>& old_level_numbers);
 		void checkRebuildConfigDependencies(const json& dependencies, const Configuration& config) const;
-		void checkRebuildResourceDependencies(const json& dependencies, const fs::path& project_root, size_t starting_index = 0) const;
+		void checkRebuildResourceDependencies(json& dependencies, const fs::path& project_root, size_t starting_index = 0);
 		std::optional<ConfigurationDependency> checkReinsertConfigDependencies(const json& config_dependencies, const Configuration& config) const;
-		std::optional<ResourceDependency> checkReinsertResourceDependencies(const json& resource_dependencies) const;
+		std::optional<ResourceDependency> checkReinsertResourceDependencies(json& resource_dependencies, const fs::path& project_root);
+		bool hasResourceChanged(json& json_resource_dependency, const fs::path& project_root);
 
-		static void cleanModule(const fs::path& module_source_path, const fs::path& temporary_rom_path, const fs::path& project_root);
+		static void cleanModule(const fs::path& module_source_path, RomImage& rom_image, const fs::path& project_root);
+		std::vector<fs::path> readOldModuleOutputs(const std::string& module_source_path, const fs::path& project_root) const;
 		void copyOldModuleOutput(const std::vector<fs::path>& module_output_paths, const fs::path& module_source_path, 
 			const fs::path& project_root);
 
@@ -1,7 +1,7 @@
 #include "rebuilder.h"
 
 namespace callisto {
-	void Rebuilder::build(const Configuration& config) {
+	void Rebuilder::build(const Configuration& config, bool resume) {
 		const auto build_start{ std::chrono::high_resolution_clock::now() };
 
 		spdlog::info(fmt::format(colors::ACTION_START, "Rebuild started"));
@@ -12,6 +12,25 @@ namespace callisto {
 		checkCleanRom(config.clean_rom.getOrThrow());
 
 		init(config);
+		// resuming keeps a journal of this rebuild either way, so a failed resume can be resumed again
+		const bool keep_journal{ resume || config.cache_journal.getOrDefault(false) };
+		if (keep_journal && checkpoint_store == nullptr) {
+			initCheckpointStore(config);
+		}
+
+		std::optional<Hasher::Hash> build_identity{};
+		if (build_cache != nullptr) {
+			build_identity = identifyBuild(config);
+			const auto artifacts{ build_cache->lookup(build_identity.value()) };
+			if (artifacts.has_value()) {
+				restoreBuild(config, artifacts.value());
+
+				const auto build_end{ std::chrono::high_resolution_clock::now() };
+				spdlog::info(fmt::format(colors::SUCCESS, "Rebuild restored from cache in {} \\(^.^)/",
+					TimeUtil::getDurationString(build_end - build_start)));
+				return;
+			}
+		}
 
 		DependencyVector dependencies{};
 		PatchHijacksVector patch_hijacks{};
@@ -19,18 +38,57 @@ namespace callisto {
 		const auto temp_rom_path{ PathUtil::getTemporaryRomPath(config.temporary_folder.getOrThrow(),
 	config.output_rom.getOrThrow()) };
 		fs::copy_file(config.clean_rom.getOrThrow(), temp_rom_path, fs::copy_options::overwrite_existing);
+		rom_image = std::make_shared<RomImage>(temp_rom_path);
 
 		auto insertables{ buildOrderToInsertables(config) };
 
+		// steps that last ran with the same inputs after the same steps don't have to run again
+		Checkpoints checkpoints{};
+		Hasher::Hash checkpoint_fingerprint{};
+		if (checkpoint_store != nullptr) {
+			checkpoint_fingerprint = identifyCheckpointChain(config);
+		}
+		if (resume) {
+			checkpoints = findJournaledCheckpoints(config, checkpoint_fingerprint, rom_image->getSize());
+		}
+		else if (config.cache_checkpoints.getOrDefault(false)) {
+			checkpoints = findCheckpoints(config, checkpoint_fingerprint, rom_image->getSize());
+		}
+		const auto resume_index{ checkpoints.size() };
+
+		std::optional<BuildJournal> journal{};
+		if (keep_journal) {
+			journal.emplace(PathUtil::getBuildJournalPath(config.project_root.getOrThrow()), checkpoint_fingerprint);
+			try {
+				std::vector<BuildJournal::Entry> kept_entries{};
+				for (size_t k{ 0 }; k != checkpoints.size(); ++k) {
+					kept_entries.push_back({ config.build_order[k].toJson(config.project_root.getOrThrow()).dump(), checkpoints[k].first });
+				}
+				journal->begin(std::move(kept_entries));
+			}
+			catch (const std::exception& e) {
+				spdlog::warn(fmt::format(colors::WARNING, "Failed to write build journal with following exception, "
+					"this rebuild can't be resumed:\n\r{}", e.what()));
+				journal.reset();
+			}
+		}
+
+		if (!checkpoints.empty()) {
+			checkpoint_fingerprint = checkpoints.back().first;
+		}
+
+		// declared ahead of the threads so it outlives the conflict worker
+		RomSnapshotQueue snapshot_queue{ CONFLICT_SNAPSHOT_QUEUE_CAPACITY };
+
 		std::jthread init_thread;
 		std::jthread conflict_thread;
 		std::exception_ptr init_thread_exception{};
 		std::exception_ptr conflict_thread_exception{};
 		bool conflict_thread_created{ false };
-		if (!insertables.empty()) {
+		if (resume_index != insertables.size()) {
 			init_thread = std::jthread([&] { 
 				try {
-					insertables[0].second->init(); 
+					insertables[resume_index].second->init(); 
 				}
 				catch (...) {
 					init_thread_exception = std::current_exception();
@@ -38,20 +96,53 @@ namespace callisto {
 			});
 		}
 
-		std::shared_ptr<WriteMap> write_map{ std::make_shared<WriteMap>() };
-		auto old_rom{ std::make_shared<std::vector<char>>() };
-		auto new_rom{ std::make_shared<std::vector<char>>() };
+		std::shared_ptr<WriteLedger> write_ledger{ std::make_shared<WriteLedger>() };
 		Conflicts check_conflicts_policy{ determineConflictCheckSetting(config) };
+		const auto conflict_log_format{ determineConflictLogFormat(config) };
 
 		if (check_conflicts_policy != Conflicts::NONE) {
-			*old_rom = getRom(temp_rom_path);
+			// interning up front keeps writer ids in build order, which Update relies on
+			for (const auto& [descriptor, _] : insertables) {
+				write_ledger->internWriter(descriptor.toString(config.project_root.getOrThrow()));
+			}
+
+			auto initial_rom{ snapshot_queue.acquireBuffer() };
+			initial_rom.assign(rom_image->getBody().begin(), rom_image->getBody().end());
+			conflict_thread_created = true;
+			conflict_thread = std::jthread([&snapshot_queue, initial_rom = std::move(initial_rom), check_conflicts_policy,
+				write_ledger, &conflict_thread_exception](std::stop_token stop_token) mutable {
+				diffSnapshots(snapshot_queue, std::move(initial_rom), check_conflicts_policy, write_ledger,
+					conflict_thread_exception, stop_token);
+			});
+		}
+
+		if (resume_index != 0) {
+			resumeFromCheckpoints(config, insertables, checkpoints, dependencies, patch_hijacks,
+				check_conflicts_policy != Conflicts::NONE ? &snapshot_queue : nullptr);
+		}
+		std::vector<char> checkpoint_rom{};
+		CheckpointFileStamps checkpoint_file_stamps{};
+		if (checkpoint_store != nullptr) {
+			checkpoint_rom = rom_image->getBody();
 		}
 
-		size_t i{ 0 };
+		size_t i{ resume_index };
 		std::optional<Insertable::NoDependencyReportFound> failed_dependency_report{};
-		for (const std::pair<const Descriptor&, std::shared_ptr<Insertable>> pair : insertables) {
+		const auto journal_failure{ [&](const Descriptor& descriptor) {
+			if (journal.has_value()) {
+				try {
+					journal->fail(descriptor.toString(config.project_root.getOrThrow()));
+				}
+				catch (const std::exception& e) {
+					spdlog::debug("Failed to record failed step in build journal: {}", e.what());
+				}
+			}
+		} };
+
+		for (const std::pair<const Descriptor&, std::shared_ptr<Insertable>> pair : insertables | std::views::drop(resume_index)) {
 			init_thread.join();
 			if (init_thread_exception != nullptr) {
+				journal_failure(pair.first);
 				std::rethrow_exception(init_thread_exception);
 			}
 			if (i != insertables.size() - 1) {
@@ -70,6 +161,14 @@ namespace callisto {
 
 			spdlog::info(fmt::format(colors::CALLISTO, "--- {} ---", descriptor.toString(config.project_root.getOrThrow())));
 
+			if (!insertable->usesRomImage()) {
+				rom_image->flush();
+			}
+
+			if (check_conflicts_policy != Conflicts::NONE) {
+				insertable->trackRomWrites();
+			}
+
 			if (!failed_dependency_report.has_value()) {
 				const auto curr_path{ fs::current_path() };
 				std::unordered_set<ResourceDependency> resource_dependencies;
@@ -80,6 +179,7 @@ namespace callisto {
 					failed_dependency_report = e;
 				}
 				catch (...) {
+					journal_failure(descriptor);
 					fs::current_path(curr_path);
 					try {
 						fs::remove_all(config.temporary_folder.getOrThrow());
@@ -111,6 +211,7 @@ namespace callisto {
 					spdlog::info("");
 				}
 				catch (...) {
+					journal_failure(descriptor);
 					fs::current_path(curr_path);
 					try {
 						fs::remove_all(config.temporary_folder.getOrThrow());
@@ -123,38 +224,74 @@ namespace callisto {
 				}
 			}
 
+			if (!insertable->usesRomImage()) {
+				rom_image->reload();
+			}
+
 			if (check_conflicts_policy != Conflicts::NONE) {
-				if (conflict_thread_created) {
-					conflict_thread.join();
+				auto rom_writes{ insertable->takeRomWrites() };
+				if (rom_writes.has_value()) {
+					snapshot_queue.push({ {}, std::move(rom_writes), descriptor.toString(config.project_root.getOrThrow()) });
 				}
 				else {
-					conflict_thread_created = true;
-				}
-
-				if (conflict_thread_exception != nullptr) {
-					std::rethrow_exception(conflict_thread_exception);
+					// only blocks if the conflict worker has fallen behind by a full queue
+					auto snapshot_rom{ snapshot_queue.acquireBuffer() };
+					snapshot_rom.assign(rom_image->getBody().begin(), rom_image->getBody().end());
+					snapshot_queue.push({ std::move(snapshot_rom), {}, descriptor.toString(config.project_root.getOrThrow()) });
 				}
+			}
 
-				*new_rom = getRom(temp_rom_path);
-				const fs::path project_root{ config.project_root.getOrThrow() };
-				conflict_thread = std::jthread([old_rom, new_rom, check_conflicts_policy, write_map, descriptor, project_root, &conflict_thread_exception] {
-					try {
-						updateWrites(old_rom, new_rom, check_conflicts_policy, write_map,
-							descriptor.toString(project_root));
-						old_rom->swap(*new_rom);
-					}
-					catch (...) {
-						conflict_thread_exception = std::current_exception();
+			// a step without a dependency report can't be fingerprinted, so neither can anything after it
+			if (checkpoint_store != nullptr && !failed_dependency_report.has_value()) {
+				try {
+					const auto& [_, step_dependencies] = dependencies.back();
+					const auto report_entry{ getJsonDependencyBlock(descriptor, step_dependencies.first, step_dependencies.second,
+						patch_hijacks.back(), config.project_root.getOrThrow()) };
+					const auto fingerprint{ fingerprintStep(checkpoint_fingerprint, report_entry, config) };
+
+					const auto& rom{ rom_image->getBody() };
+					checkpoint_store->record(checkpoint_fingerprint, report_entry["descriptor"].dump(), fingerprint,
+						RomDelta::between(checkpoint_rom, rom), collectCheckpointFiles(config, *checkpoint_store, checkpoint_file_stamps),
+						report_entry.dump());
+					if (journal.has_value()) {
+						journal->append(report_entry["descriptor"].dump(), fingerprint);
 					}
-				});
-				// conflict_thread.join();
+
+					checkpoint_fingerprint = fingerprint;
+					checkpoint_rom.assign(rom.begin(), rom.end());
+				}
+				catch (const std::exception& e) {
+					spdlog::warn(fmt::format(colors::WARNING, "Failed to record checkpoint with following exception, "
+						"no further checkpoints will be taken:\n\r{}", e.what()));
+					checkpoint_store = nullptr;
+					journal.reset();
+				}
 			}
 		}
 
 		if (conflict_thread_created) {
+			snapshot_queue.close();
 			conflict_thread.join();
 		}
 
+		std::optional<OwnershipIndex> ownership_index{};
+		try {
+			// kept around so Update can check conflicts without diffing every step again
+			if (check_conflicts_policy != Conflicts::NONE && conflict_thread_exception == nullptr) {
+				ownership_index = writeWriteLedger(config.project_root.getOrThrow(), *write_ledger, check_conflicts_policy);
+			}
+			else {
+				removeWriteLedger(config.project_root.getOrThrow());
+			}
+		}
+		catch (const std::exception& e) {
+			spdlog::warn(fmt::format(colors::WARNING, "Failed to write conflict ledger with following exception, "
+				"Update will not check for conflicts:\n\r{}", e.what()));
+		}
+
+		writeFreespaceIndex(config.project_root.getOrThrow(), rom_image->getBody(),
+			ownership_index.has_value() ? &ownership_index.value() : nullptr);
+
 		if (check_conflicts_policy != Conflicts::NONE) {
 			conflict_thread_created = true;
 			const auto conflict_log_file{ config.conflict_log_file.isSet() ?
@@ -162,10 +299,12 @@ namespace callisto {
 						std::nullopt };
 			const auto &ignored_symbols{ config.ignored_conflict_symbols };
 			const auto& project_root{ config.project_root.getOrThrow() };
-			conflict_thread = std::jthread([&conflict_thread_exception, write_map, conflict_log_file, check_conflicts_policy, ignored_symbols, project_root] {
+			const auto rom_mapper{ RomView::detectMapper(rom_image->getBody()) };
+			conflict_thread = std::jthread([&conflict_thread_exception, write_ledger, conflict_log_file, conflict_log_format,
+				check_conflicts_policy, ignored_symbols, project_root, rom_mapper] {
 				try {
-					reportConflicts(write_map, conflict_log_file, check_conflicts_policy, conflict_thread_exception, 
-						ignored_symbols, project_root);
+					reportConflicts(write_ledger, conflict_log_file, conflict_log_format, check_conflicts_policy, conflict_thread_exception, 
+						ignored_symbols, project_root, rom_mapper);
 				}
 				catch (...) {
 					conflict_thread_exception = std::current_exception();
@@ -175,7 +314,7 @@ namespace callisto {
 
 		if (!failed_dependency_report.has_value()) {
 			try {
-				const auto insertion_report{ getJsonDependencies(dependencies, patch_hijacks) };
+				const auto insertion_report{ getJsonDependencies(dependencies, patch_hijacks, config.project_root.getOrThrow()) };
 
 				writeBuildReport(config.project_root.getOrThrow(), createBuildReport(config, insertion_report));
 			}
@@ -194,7 +333,29 @@ namespace callisto {
 
 		cacheModules(config.project_root.getOrThrow());
 
-		Saver::writeMarkerToRom(temp_rom_path, config);
+		if (build_cache != nullptr && !failed_dependency_report.has_value()) {
+			try {
+				rom_image->flush();
+				build_cache->record(build_identity.value(), readBuildReportDependencies(config.project_root.getOrThrow()),
+					collectBuildArtifacts(config));
+			}
+			catch (const std::exception& e) {
+				spdlog::warn(fmt::format(colors::WARNING, "Failed to cache build with following exception:\n\r{}", e.what()));
+			}
+		}
+
+		evictStepCache();
+
+		if (checkpoint_store != nullptr) {
+			try {
+				checkpoint_store->evict();
+			}
+			catch (const std::exception& e) {
+				spdlog::warn(fmt::format(colors::WARNING, "Failed to clean up checkpoints with following exception:\n\r{}", e.what()));
+			}
+		}
+
+		Saver::writeMarkerToRom(*rom_image, config);
 		moveTempToOutput(config);
 
 		const auto build_end{ std::chrono::high_resolution_clock::now() };
@@ -224,7 +385,29 @@ namespace callisto {
 			TimeUtil::getDurationString(build_end - build_start)));
 	}
 
-	json Rebuilder::getJsonDependencies(const DependencyVector& dependencies, const PatchHijacksVector& hijacks) {
+	void Rebuilder::restoreBuild(const Configuration& config, const BuildCache::Artifacts& artifacts) {
+		spdlog::info(fmt::format(colors::CALLISTO, "Restoring identical build from cache"));
+		spdlog::info("");
+
+		restoreBuildArtifacts(config, artifacts);
+
+		GraphicsUtil::linkOutputRomToProjectGraphics(config, false);
+		GraphicsUtil::linkOutputRomToProjectGraphics(config, true);
+
+		Saver::writeMarkerToRom(PathUtil::getTemporaryRomPath(config.temporary_folder.getOrThrow(),
+			config.output_rom.getOrThrow()), config);
+		moveTempToOutput(config);
+
+		try {
+			fs::remove_all(config.temporary_folder.getOrThrow());
+		}
+		catch (const std::runtime_error&) {
+			spdlog::warn(fmt::format(colors::WARNING, "Failed to remove temporary folder '{}'",
+				config.temporary_folder.getOrThrow().string()));
+		}
+	}
+
+	json Rebuilder::getJsonDependencies(const DependencyVector& dependencies, const PatchHijacksVector& hijacks, const fs::path& project_root) {
 		json j;
 
 		std::unordered_set<Descriptor> seen{};
@@ -237,27 +420,7 @@ namespace callisto {
 
 			seen.insert(descriptor);
 
-			auto block{ json({
-				{"descriptor", descriptor.toJson()},
-				{"resource_dependencies", std::vector<json>()},
-				{"configuration_dependencies", std::vector<json>()}
-			}) };
-
-			for (const auto& resource_dependency : pair.first) {
-				block["resource_dependencies"].push_back(resource_dependency.toJson());
-			}
-
-			for (const auto& config_dependency : pair.second) {
-				block["configuration_dependencies"].push_back(config_dependency.toJson());
-			}
-
-			const auto& patch_hijacks{ hijacks[i--] };
-			 
-			if (patch_hijacks.has_value()) {
-				block["hijacks"] = patch_hijacks.value();
-			}
-
-			j.push_back(block);
+			j.push_back(getJsonDependencyBlock(descriptor, pair.first, pair.second, hijacks[i--], project_root));
 		}
 
 		std::reverse(j.begin(), j.end());
@@ -265,209 +428,392 @@ namespace callisto {
 		return j;
 	}
 
-	void Rebuilder::reportConflicts(std::shared_ptr<WriteMap> write_map, const std::optional<fs::path>& log_file_path,
-		Conflicts conflict_policy, std::exception_ptr conflict_exception, const std::unordered_set<Descriptor>& ignored_descriptors, 
-		const fs::path& project_root) {
-		if (conflict_policy == Conflicts::NONE) {
-			spdlog::info(fmt::format(colors::NOTIFICATION, "Not set to detect conflicts"));
-			return;
+	json Rebuilder::getJsonDependencyBlock(const Descriptor& descriptor, const std::unordered_set<ResourceDependency>& resource_dependencies,
+		const std::unordered_set<ConfigurationDependency>& config_dependencies,
+		const std::optional<std::vector<std::pair<size_t, size_t>>>& hijacks, const fs::path& project_root) {
+		auto block{ json({
+			{"descriptor", descriptor.toJson(project_root)},
+			{"resource_dependencies", std::vector<json>()},
+			{"configuration_dependencies", std::vector<json>()}
+		}) };
+
+		for (const auto& resource_dependency : resource_dependencies) {
+			block["resource_dependencies"].push_back(resource_dependency.toJson(project_root));
 		}
 
-		if (conflict_exception != nullptr) {
-			try {
-				std::rethrow_exception(conflict_exception);
-			}
-			catch (const std::exception& e) {
-				spdlog::warn(fmt::format(colors::WARNING, "The following exception prevented conflict detection:\n\r{}", e.what()));
-				return;
-			}
+		for (const auto& config_dependency : config_dependencies) {
+			block["configuration_dependencies"].push_back(config_dependency.toJson());
 		}
 
-		std::unordered_set<std::string> ignored_names{};
-		for (const auto& descriptor : ignored_descriptors) {
-			ignored_names.insert(descriptor.toString(project_root));
+		if (hijacks.has_value()) {
+			block["hijacks"] = hijacks.value();
 		}
 
-		std::ostringstream log{};
-		int conflicts{ 0 };
-		const auto log_to_file{ log_file_path.has_value() };
+		return block;
+	}
 
-		auto current{ write_map->begin() };
-		bool one_logged{ false };
-		while (current != write_map->end()) {
-			auto& pc_offset{ current->first };
-			auto writes{ current->second };
+	Hasher::Hash Rebuilder::identifyCheckpointChain(const Configuration& config) {
+		Hasher hasher{};
+		hasher.updateValue(CheckpointStore::FORMAT_VERSION);
+		hasher.updateString(fmt::format("{}.{}.{}", CALLISTO_VERSION_MAJOR, CALLISTO_VERSION_MINOR, CALLISTO_VERSION_PATCH));
+		hasher.updateValue(Hasher::hashFile(config.clean_rom.getOrThrow()));
+		return hasher.digest();
+	}
 
-			if (!writesAreIdentical(writes, ignored_names)) {
-				auto writers{ getWriters(writes) };
-				ConflictVector written_bytes{};
-				for (const auto& writer : writers) {
-					written_bytes.push_back({ writer, {} });
-				}
-				int conflict_size{ 0 };
-				do {
-					for (int i{ 0 }; i != writers.size(); ++i) {
-						const auto written_byte{ current->second.at(i).second };
-						written_bytes.at(i).second.push_back(written_byte);
-					}
-					++conflict_size;
-					++current;
-				} while (current != write_map->end() && writers == getWriters(current->second) && !writesAreIdentical(current->second, ignored_names));
-				const auto conflict_string{ getConflictString(
-					written_bytes, pc_offset, conflict_size, !log_to_file) };
-				++conflicts;
-				if (log_to_file) {
-					if (one_logged) {
-						log << '\n';
-					}
-					else {
-						one_logged = true;
-					}
-					log << conflict_string;
-				}
-				else {
-					spdlog::warn(conflict_string);
+	Hasher::Hash Rebuilder::fingerprintStep(Hasher::Hash previous, const json& report_entry, const Configuration& config) {
+		const auto& project_root{ config.project_root.getOrThrow() };
+
+		Hasher hasher{};
+		hasher.updateValue(previous);
+		hasher.updateString(report_entry["descriptor"].dump());
+
+		// folders stand for everything below them, same as for Update
+		std::vector<fs::path> files{};
+		for (const auto& json_resource_dependency : report_entry["resource_dependencies"]) {
+			const auto path{ ResourceDependency(json_resource_dependency, project_root).dependent_path };
+			files.push_back(path);
+			if (fs::is_directory(path)) {
+				for (const auto& entry : fs::recursive_directory_iterator(path)) {
+					files.push_back(entry.path());
 				}
 			}
+		}
+		std::sort(files.begin(), files.end());
+		files.erase(std::unique(files.begin(), files.end()), files.end());
+
+		hasher.updateValue(files.size());
+		for (const auto& file : files) {
+			hasher.updateString(PathUtil::toPortable(file, project_root));
+			if (!fs::exists(file)) {
+				hasher.updateValue(0);
+			}
+			else if (fs::is_directory(file)) {
+				hasher.updateValue(1);
+			}
 			else {
-				++current;
+				hasher.updateValue(2);
+				hasher.updateValue(Hasher::hashFile(file));
 			}
 		}
-		
-		if (conflicts == 0) {
-			if (log_to_file && fs::exists(log_file_path.value())) {
-				fs::remove(log_file_path.value());
-			}
-			spdlog::info(fmt::format(colors::PARTIAL_SUCCESS, "No conflicts found"));
+
+		// the current values, so a changed setting leads to a different fingerprint
+		std::vector<std::string> settings{};
+		for (const auto& json_config_dependency : report_entry["configuration_dependencies"]) {
+			const ConfigurationDependency recorded{ json_config_dependency };
+			const ConfigurationDependency current{ recorded.config_keys, config.getByKey(recorded.config_keys), recorded.policy };
+			settings.push_back(PathUtil::toPortableText(current.toJson().dump(), project_root));
 		}
-		else if (log_to_file) {
-			std::ofstream log_file{ log_file_path.value() };
-			log_file << log.str();
-			spdlog::warn(fmt::format(colors::WARNING, "{} conflict(s) logged to {}", 
-				conflicts, log_file_path.value().string()));
+		std::sort(settings.begin(), settings.end());
+
+		hasher.updateValue(settings.size());
+		for (const auto& setting : settings) {
+			hasher.updateString(setting);
 		}
+
+		return hasher.digest();
 	}
 
-	std::string Rebuilder::getConflictString(const ConflictVector& conflict_vector, int pc_start_offset, int conflict_size, bool for_console) {
-		std::ostringstream output{};
-		const auto byte_or_bytes{ conflict_size == 1 ? "byte" : "bytes" };
-		const auto line_end{ for_console ? "\n\r" : "\n" };
-		output << fmt::format(
-			"Conflict - 0x{:X} {} at SNES: ${:06X} (unheadered), PC: 0x{:06X} (headered):{}",
-			conflict_size, byte_or_bytes,
-			pcToSnes(pc_start_offset), pc_start_offset + 0x200,  // idk if the + 0x200 is controversial
-			line_end
-		);
-
-		for (const auto& [writer, written_bytes] : conflict_vector) {
-			output << '\t' << writer << ':';
-			int i{ 0 };
-			while (i != written_bytes.size()) {
-				if (for_console && i == 0x100) {
-					output << "...";
-					break;
-				}
-				if (i % 0x10 == 0) {
-					output << line_end << "\t\t";
-				}
-				output << fmt::format("{:02X} ", written_bytes.at(i++));
+	Rebuilder::Checkpoints Rebuilder::findCheckpoints(const Configuration& config, Hasher::Hash chain_root, size_t clean_rom_size) const {
+		Checkpoints checkpoints{};
+		auto previous{ chain_root };
+		auto rom_size{ clean_rom_size };
+
+		for (const auto& descriptor : config.build_order) {
+			const auto manifest{ checkpoint_store->getManifest(previous, descriptor.toJson(config.project_root.getOrThrow()).dump()) };
+			if (!manifest.has_value()) {
+				break;
+			}
+
+			Hasher::Hash fingerprint;
+			try {
+				fingerprint = fingerprintStep(previous, json::parse(manifest.value()), config);
 			}
-			output << line_end;
+			catch (const std::exception& e) {
+				spdlog::debug("Ignoring unreadable checkpoint manifest: {}", e.what());
+				break;
+			}
+
+			auto checkpoint{ checkpoint_store->get(fingerprint) };
+			if (!checkpoint.has_value() || checkpoint.value().delta.getSizeBefore() != rom_size) {
+				break;
+			}
+
+			rom_size = checkpoint.value().delta.getSizeAfter();
+			previous = fingerprint;
+			checkpoints.push_back({ fingerprint, std::move(checkpoint.value()) });
 		}
 
-		return output.str();
+		return checkpoints;
 	}
 
-	bool Rebuilder::writesAreIdentical(const Writes& writes, const std::unordered_set<std::string>& ignored_names) {
-		if (writes.size() == 1) {
-			return true;
+	Rebuilder::Checkpoints Rebuilder::findJournaledCheckpoints(const Configuration& config, Hasher::Hash chain_root,
+		size_t clean_rom_size) const {
+		Checkpoints checkpoints{};
+		const auto& project_root{ config.project_root.getOrThrow() };
+
+		const auto journal{ BuildJournal::read(PathUtil::getBuildJournalPath(project_root)) };
+		if (!journal.has_value()) {
+			spdlog::info(fmt::format(colors::NOTIFICATION, "No build journal found, rebuilding from scratch"));
+			spdlog::info("");
+			return checkpoints;
 		}
-		std::optional<unsigned char> byte_to_match{};
-		for (auto it{ writes.begin() + 1 }; it != writes.end(); ++it) {
-			if (ignored_names.contains(it->first)) {
-				continue;
+		if (journal->getChainRoot() != chain_root) {
+			spdlog::info(fmt::format(colors::NOTIFICATION, "Clean ROM or callisto version changed since the last rebuild, rebuilding from scratch"));
+			spdlog::info("");
+			return checkpoints;
+		}
+		if (journal->getFailedStep().has_value()) {
+			spdlog::info(fmt::format(colors::CALLISTO, "Last rebuild failed at {}", journal->getFailedStep().value()));
+		}
+
+		auto previous{ chain_root };
+		auto rom_size{ clean_rom_size };
+		const auto& entries{ journal->getEntries() };
+		for (size_t k{ 0 }; k != entries.size() && k != config.build_order.size(); ++k) {
+			const auto& [step, fingerprint] = entries[k];
+			if (step != config.build_order[k].toJson(project_root).dump()) {
+				break;
 			}
 
-			if (!byte_to_match.has_value()) {
-				byte_to_match = it->second;
+			auto checkpoint{ checkpoint_store->get(fingerprint) };
+			if (!checkpoint.has_value() || checkpoint.value().delta.getSizeBefore() != rom_size) {
+				break;
 			}
-			else if (byte_to_match.value() != it->second) {
-				return false;
+
+			// the journal only says what ran last time, the inputs have to match what's there now
+			try {
+				if (fingerprintStep(previous, json::parse(checkpoint.value().report_entry), config) != fingerprint) {
+					break;
+				}
+			}
+			catch (const std::exception& e) {
+				spdlog::debug("Ignoring unreadable checkpoint: {}", e.what());
+				break;
 			}
+
+			rom_size = checkpoint.value().delta.getSizeAfter();
+			previous = fingerprint;
+			checkpoints.push_back({ fingerprint, std::move(checkpoint.value()) });
 		}
 
-		return true;
+		if (checkpoints.empty()) {
+			spdlog::info(fmt::format(colors::NOTIFICATION, "Nothing to resume from, rebuilding from scratch"));
+			spdlog::info("");
+		}
+		return checkpoints;
 	}
 
-	int Rebuilder::pcToSnes(int address) {
-		int snes{ ((address << 1) & 0x7F0000) | (address & 0x7FFF) | 0x8000 };
-		return snes;
-	}
+	void Rebuilder::resumeFromCheckpoints(const Configuration& config, const Insertables& insertables, const Checkpoints& checkpoints,
+		DependencyVector& dependencies, PatchHijacksVector& patch_hijacks, RomSnapshotQueue* snapshot_queue) {
+		const auto& project_root{ config.project_root.getOrThrow() };
+
+		spdlog::info(fmt::format(colors::CALLISTO, "Resuming after {} from checkpoint, {} of {} steps are up to date",
+			insertables[checkpoints.size() - 1].first.toString(project_root), checkpoints.size(), insertables.size()));
+		spdlog::info("");
+
+		auto rom{ rom_image->getBody() };
+		for (size_t i{ 0 }; i != checkpoints.size(); ++i) {
+			const auto& descriptor{ insertables[i].first };
+			const auto& [_, checkpoint] = checkpoints[i];
+
+			rom.resize(std::max(checkpoint.delta.getSizeBefore(), checkpoint.delta.getSizeAfter()));
+			checkpoint.delta.applyTo(rom);
+			rom.resize(checkpoint.delta.getSizeAfter());
+
+			// the conflict worker gets to see every step, so the ledger ends up the same as without checkpoints
+			if (snapshot_queue != nullptr) {
+				auto snapshot_rom{ snapshot_queue->acquireBuffer() };
+				snapshot_rom.assign(rom.begin(), rom.end());
+				snapshot_queue->push({ std::move(snapshot_rom), {}, descriptor.toString(project_root) });
+			}
 
-	std::vector<std::string> Rebuilder::getWriters(const Writes& writes) {
-		std::vector<std::string> writers{};
-		for (const auto& [writer, _] : writes) {
-			writers.push_back(writer);
+			// the resources are the same as when the checkpoint was taken, their write times may not be
+			const json report_entry = json::parse(checkpoint.report_entry);
+			std::unordered_set<ResourceDependency> resource_dependencies{};
+			for (const auto& json_resource_dependency : report_entry["resource_dependencies"]) {
+				const ResourceDependency recorded{ json_resource_dependency, project_root };
+				resource_dependencies.insert(ResourceDependency(recorded.dependent_path, recorded.policy));
+			}
+			std::unordered_set<ConfigurationDependency> config_dependencies{};
+			for (const auto& json_config_dependency : report_entry["configuration_dependencies"]) {
+				config_dependencies.insert(ConfigurationDependency(json_config_dependency));
+			}
+			dependencies.push_back({ descriptor, { resource_dependencies, config_dependencies } });
+
+			if (report_entry.contains("hijacks")) {
+				patch_hijacks.push_back(report_entry["hijacks"].get<std::vector<std::pair<size_t, size_t>>>());
+			}
+			else {
+				patch_hijacks.push_back({});
+			}
 		}
-		return writers;
+
+		restoreCheckpointFiles(config, checkpoints.back().second);
+
+		{
+			std::ofstream rom_file{ rom_image->getPath(), std::ios::out | std::ios::binary };
+			rom_file.write(rom_image->getHeader().data(), rom_image->getHeader().size());
+			rom_file.write(rom.data(), rom.size());
+			if (!rom_file) {
+				throw CallistoException(fmt::format("Failed to write checkpoint ROM to {}", rom_image->getPath().string()));
+			}
+		}
+		rom_image->reload();
 	}
 
-	std::vector<char> Rebuilder::getRom(const fs::path& rom_path) {
-		std::ifstream rom_file(rom_path, std::ios::in | std::ios::binary);
-		std::vector<char> rom_bytes((std::istreambuf_iterator<char>(rom_file)), (std::istreambuf_iterator<char>()));
-		rom_file.close();
+	std::vector<std::pair<std::string, Hasher::Hash>> Rebuilder::collectCheckpointFiles(const Configuration& config,
+		CheckpointStore& checkpoint_store, CheckpointFileStamps& file_stamps) {
+		const auto& project_root{ config.project_root.getOrThrow() };
+		std::vector<std::pair<std::string, Hasher::Hash>> files{};
+		CheckpointFileStamps current_stamps{};
+
+		// only files whose size or write time changed since the previous checkpoint are read and stored again
+		const auto add_file{ [&](const fs::path& path) {
+			auto portable_path{ PathUtil::toPortable(path, project_root) };
+			const auto size{ fs::file_size(path) };
+			const auto last_write_time{ fs::last_write_time(path) };
+
+			const auto previous{ file_stamps.find(portable_path) };
+			Hasher::Hash hash{};
+			if (previous != file_stamps.end() && previous->second.size == size
+				&& previous->second.last_write_time == last_write_time) {
+				hash = previous->second.hash;
+			}
+			else {
+				std::ifstream file{ path, std::ios::in | std::ios::binary };
+				hash = checkpoint_store.putFile(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+			}
 
-		int rom_size{ static_cast<int>(rom_bytes.size()) };
-		const auto header_size{ rom_size & 0x7FFF };
+			current_stamps.insert({ portable_path, { size, last_write_time, hash } });
+			files.push_back({ std::move(portable_path), hash });
+		} };
+
+		// module outputs and cleanup files are what later steps and Update pick up from earlier ones
+		for (const auto& directory : { PathUtil::getUserModuleDirectoryPath(project_root),
+			PathUtil::getModuleCleanupDirectoryPath(project_root) }) {
+			if (fs::exists(directory)) {
+				for (const auto& entry : fs::recursive_directory_iterator(directory)) {
+					if (entry.is_regular_file()) {
+						add_file(entry.path());
+					}
+				}
+			}
+		}
 
-		std::vector<char> unheadered(rom_bytes.begin() + header_size, rom_bytes.end());
+		// whatever Lunar Magic put next to the temporary ROM, same as moveTempToOutput picks up
+		const auto temporary_rom_path{ PathUtil::getTemporaryRomPath(config.temporary_folder.getOrThrow(),
+			config.output_rom.getOrThrow()) };
+		for (const auto& side_file : PathUtil::getTemporaryRomSideFiles(temporary_rom_path)) {
+			add_file(side_file);
+		}
 
-		return unheadered;
+		// files that are gone don't carry over
+		file_stamps = std::move(current_stamps);
+		return files;
 	}
 
-	void Rebuilder::updateWrites(std::shared_ptr<std::vector<char>> old_rom, std::shared_ptr<std::vector<char>> new_rom,
-		Conflicts conflict_policy, std::shared_ptr<WriteMap> write_map, const std::string& descriptor_string) {
-		if (conflict_policy == Conflicts::NONE) {
-			return;
+	void Rebuilder::restoreCheckpointFiles(const Configuration& config, const CheckpointStore::Checkpoint& checkpoint) {
+		const auto& project_root{ config.project_root.getOrThrow() };
+
+		fs::remove_all(PathUtil::getUserModuleDirectoryPath(project_root));
+		fs::remove_all(PathUtil::getModuleCleanupDirectoryPath(project_root));
+		fs::create_directories(PathUtil::getUserModuleDirectoryPath(project_root));
+		fs::create_directories(PathUtil::getModuleCleanupDirectoryPath(project_root));
+
+		for (const auto& [portable_path, contents] : checkpoint.files) {
+			const auto path{ PathUtil::fromPortable(portable_path, project_root) };
+			fs::create_directories(path.parent_path());
+			std::ofstream file{ path, std::ios::out | std::ios::binary };
+			file.write(contents.data(), contents.size());
+			if (!file) {
+				throw CallistoException(fmt::format("Failed to restore checkpoint file {}", path.string()));
+			}
 		}
-		int size{ static_cast<int>(std::min(old_rom->size(), new_rom->size())) };
 
-		if (conflict_policy == Conflicts::HIJACKS) {
-			size = std::min(size, 0x80000);
+		// later modules must still be able to tell the labels of earlier ones apart from their own, see QuickBuilder
+		for (const auto& entry : fs::recursive_directory_iterator(PathUtil::getModuleCleanupDirectoryPath(project_root))) {
+			if (!entry.is_regular_file()) {
+				continue;
+			}
+			std::ifstream cleanup_file{ entry.path() };
+			std::string line;
+			while (std::getline(cleanup_file, line)) {
+				module_addresses->insert(std::stoi(line));
+			}
 		}
+	}
 
-		for (int i{ 0 }; i != size; ++i) {
-			if (i == 0x07FDC) {
-				// skip checksum and inverse checksum
-				i += 3;
+	void Rebuilder::diffSnapshots(RomSnapshotQueue& snapshot_queue, std::vector<char> old_rom, Conflicts conflict_policy,
+		std::shared_ptr<WriteLedger> write_ledger, std::exception_ptr& conflict_exception, std::stop_token stop_token) {
+		while (auto snapshot{ snapshot_queue.pop(stop_token) }) {
+			if (snapshot.value().writes.has_value()) {
+				if (conflict_exception == nullptr) {
+					try {
+						applyWrites(old_rom, snapshot.value().writes.value(), conflict_policy, write_ledger,
+							snapshot.value().descriptor_string);
+					}
+					catch (...) {
+						conflict_exception = std::current_exception();
+					}
+				}
 				continue;
 			}
 
-			if (i >= old_rom->size() || old_rom->at(i) != new_rom->at(i)) {
-				if (write_map->find(i) == write_map->end() && i < old_rom->size()) {
-					(*write_map)[i].push_back({ "Original bytes", old_rom->at(i)});
+			// keep draining after a failure so the build loop never waits on a dead worker
+			if (conflict_exception == nullptr) {
+				try {
+					updateWrites(old_rom, snapshot.value().rom, conflict_policy, write_ledger, snapshot.value().descriptor_string);
+				}
+				catch (...) {
+					conflict_exception = std::current_exception();
 				}
-				(*write_map)[i].push_back({ descriptor_string, new_rom->at(i) });
 			}
+
+			snapshot_queue.recycle(std::move(old_rom));
+			old_rom = std::move(snapshot.value().rom);
 		}
 	}
 
-	Rebuilder::Conflicts Rebuilder::determineConflictCheckSetting(const Configuration& config) {
-		const auto setting{ config.check_conflicts.getOrDefault("hijacks") };
-		if (setting == "all") {
-			return Conflicts::ALL;
-		}
-		else if (setting == "hijacks") {
-			return Conflicts::HIJACKS;
+	void Rebuilder::updateWrites(const std::vector<char>& old_rom, const std::vector<char>& new_rom,
+		Conflicts conflict_policy, std::shared_ptr<WriteLedger> write_ledger, const std::string& descriptor_string) {
+		if (conflict_policy == Conflicts::NONE) {
+			return;
 		}
-		else if (setting == "none") {
-			return Conflicts::NONE;
+
+		const auto writer{ write_ledger->internWriter(descriptor_string) };
+
+		for (const auto& [start, end] : getChangedRanges(old_rom, new_rom, conflict_policy)) {
+			write_ledger->recordWrite(writer, static_cast<int>(start), static_cast<int>(end - start),
+				old_rom.data() + start, new_rom.data() + start);
 		}
-		else {
-			throw CallistoException(fmt::format(
-				"Unknown settings.check_conflicts setting '{}'",
-				setting
-			));
+	}
+
+	void Rebuilder::applyWrites(std::vector<char>& rom, const std::vector<Insertable::RomWrite>& rom_writes,
+		Conflicts conflict_policy, std::shared_ptr<WriteLedger> write_ledger, const std::string& descriptor_string) {
+		const auto writer{ write_ledger->internWriter(descriptor_string) };
+
+		for (const auto& rom_write : rom_writes) {
+			if (rom_write.pc_offset + rom_write.bytes.size() > rom.size()) {
+				throw CallistoException(fmt::format(
+					"{} wrote to PC offset 0x{:06X}, which is outside of the ROM",
+					descriptor_string, rom_write.pc_offset
+				));
+			}
+
+			const auto old_bytes{ rom.data() + rom_write.pc_offset };
+			auto changed_ranges{ RomDiff::changedRanges(old_bytes, rom_write.bytes.data(), rom_write.bytes.size()) };
+			for (auto& [start, end] : changed_ranges) {
+				start += rom_write.pc_offset;
+				end += rom_write.pc_offset;
+			}
+
+			for (const auto& [start, end] : excludeUncheckedRanges(changed_ranges, conflict_policy)) {
+				write_ledger->recordWrite(writer, static_cast<int>(start), static_cast<int>(end - start),
+					rom.data() + start, rom_write.bytes.data() + (start - rom_write.pc_offset));
+			}
+
+			// keep the worker's copy of the ROM in sync for steps that still need a full diff
+			std::copy(rom_write.bytes.begin(), rom_write.bytes.end(), rom.begin() + rom_write.pc_offset);
 		}
 	}
 }
@@ -1,7 +1,8 @@
 #pragma once
 
 #include <chrono>
-#include <sstream>
+#include <ranges>
+#include <unordered_map>
 
 #include <boost/range/adaptor/reversed.hpp>
 #include <spdlog/spdlog.h>
@@ -9,36 +10,49 @@
 #include "builder.h"
 #include "../configuration/configuration.h"
 #include "../insertables/initial_patch.h"
+#include "../conflicts/rom_snapshot_queue.h"
+#include "../cache/build_journal.h"
 
 namespace callisto {
 	class Rebuilder : public Builder {
 	protected:
-		using Writes = std::vector<std::pair<std::string, unsigned char>>;
-		using WriteMap = std::map<int, Writes>;
-		using ConflictVector = std::vector<std::pair<std::string, std::vector<unsigned char>>>;
+		static constexpr auto CONFLICT_SNAPSHOT_QUEUE_CAPACITY{ 4 };
+
 		using PatchHijacksVector = std::vector<std::optional<std::vector<std::pair<size_t, size_t>>>>;
+		using Checkpoints = std::vector<std::pair<Hasher::Hash, CheckpointStore::Checkpoint>>;
 
-		enum class Conflicts {
-			NONE,
-			HIJACKS,
-			ALL
+		// What a file looked like when it was last put into the checkpoint store, so it isn't read again while it stays that way
+		struct CheckpointFileStamp {
+			uintmax_t size;
+			fs::file_time_type last_write_time;
+			Hasher::Hash hash;
 		};
+		using CheckpointFileStamps = std::unordered_map<std::string, CheckpointFileStamp>;
+
+		static void restoreBuild(const Configuration& config, const BuildCache::Artifacts& artifacts);
+		static json getJsonDependencies(const DependencyVector& dependencies, const PatchHijacksVector& hijacks, const fs::path& project_root);
+		static json getJsonDependencyBlock(const Descriptor& descriptor, const std::unordered_set<ResourceDependency>& resource_dependencies,
+			const std::unordered_set<ConfigurationDependency>& config_dependencies,
+			const std::optional<std::vector<std::pair<size_t, size_t>>>& hijacks, const fs::path& project_root);
 
-		static json getJsonDependencies(const DependencyVector& dependencies, const PatchHijacksVector& hijacks);
-		static void reportConflicts(std::shared_ptr<WriteMap> write_map, const std::optional<fs::path>& log_file_path,
-			Conflicts conflict_policy, std::exception_ptr conflict_exception, const std::unordered_set<Descriptor>& ignored_descriptors,
-			const fs::path& project_root);
-		static std::string getConflictString(const ConflictVector& conflict_vector, 
-			int pc_start_offset, int conflict_size, bool for_console = true);
-		static bool writesAreIdentical(const Writes& writes, const std::unordered_set<std::string>& ignored_names);
-		static int pcToSnes(int address);
-		static std::vector<std::string> getWriters(const Writes& writes);
-		static std::vector<char> getRom(const fs::path& rom_path);
-		static void updateWrites(std::shared_ptr<std::vector<char>> old_rom, std::shared_ptr<std::vector<char>> new_rom,
-			Conflicts conflict_policy, std::shared_ptr<WriteMap> write_map, const std::string& descriptor_string);
-		static Conflicts determineConflictCheckSetting(const Configuration& config);
+		static Hasher::Hash identifyCheckpointChain(const Configuration& config);
+		static Hasher::Hash fingerprintStep(Hasher::Hash previous, const json& report_entry, const Configuration& config);
+		Checkpoints findCheckpoints(const Configuration& config, Hasher::Hash chain_root, size_t clean_rom_size) const;
+		Checkpoints findJournaledCheckpoints(const Configuration& config, Hasher::Hash chain_root, size_t clean_rom_size) const;
+		void resumeFromCheckpoints(const Configuration& config, const Insertables& insertables, const Checkpoints& checkpoints,
+			DependencyVector& dependencies, PatchHijacksVector& patch_hijacks, RomSnapshotQueue* snapshot_queue);
+		static std::vector<std::pair<std::string, Hasher::Hash>> collectCheckpointFiles(const Configuration& config,
+			CheckpointStore& checkpoint_store, CheckpointFileStamps& file_stamps);
+		void restoreCheckpointFiles(const Configuration& config, const CheckpointStore::Checkpoint& checkpoint);
+		static void diffSnapshots(RomSnapshotQueue& snapshot_queue, std::vector<char> old_rom, Conflicts conflict_policy,
+			std::shared_ptr<WriteLedger> write_ledger, std::exception_ptr& conflict_exception, std::stop_token stop_token);
+		static void applyWrites(std::vector<char>& rom, const std::vector<Insertable::RomWrite>& rom_writes,
+			Conflicts conflict_policy, std::shared_ptr<WriteLedger> write_ledger, const std::string& descriptor_string);
+		static void updateWrites(const std::vector<char>& old_rom, const std::vector<char>& new_rom,
+			Conflicts conflict_policy, std::shared_ptr<WriteLedger> write_ledger, const std::string& descriptor_string);
 
 	public:
-		void build(const Configuration& config);
+		// With resume set, continues after the steps of the last rebuild whose inputs haven't changed since, see BuildJournal
+		void build(const Configuration& config, bool resume = false);
 	};
 }
@@ -0,0 +1,274 @@
+#include "asar_cache.h"
+
+namespace callisto {
+	AsarCache::AsarCache(const fs::path& store_root, const fs::path& project_root,
+		const std::optional<fs::path>& shared_store_root) 
+		: store(store_root, shared_store_root), project_root(project_root) {}
+
+	Hasher::Hash AsarCache::identify(const Invocation& invocation) const {
+		Hasher hasher{};
+		hasher.updateValue(FORMAT_VERSION);
+		hasher.updateString(PathUtil::toPortableText(invocation.source, project_root));
+
+		hasher.updateValue(invocation.include_paths.size());
+		for (const auto& include_path : invocation.include_paths) {
+			hasher.updateString(PathUtil::toPortable(include_path, project_root));
+		}
+
+		hasher.updateValue(invocation.defines.size());
+		for (const auto& [name, value] : invocation.defines) {
+			hasher.updateString(name);
+			hasher.updateString(PathUtil::toPortableText(value, project_root));
+		}
+
+		return hasher.digest();
+	}
+
+	std::optional<Hasher::Hash> AsarCache::resultKey(Hasher::Hash identity, const std::vector<fs::path>& dependencies) const {
+		Hasher hasher{};
+		hasher.updateValue(identity);
+
+		hasher.updateValue(dependencies.size());
+		for (const auto& dependency : dependencies) {
+			if (!fs::is_regular_file(dependency)) {
+				return {};
+			}
+			hasher.updateString(PathUtil::toPortable(dependency, project_root));
+			hasher.updateValue(Hasher::hashFile(dependency));
+		}
+
+		hasher.updateValue(rom_before_hash);
+		return hasher.digest();
+	}
+
+	std::vector<fs::path> AsarCache::resolveDependencies(const Invocation& invocation, const std::vector<std::string>& dependency_report) {
+		std::vector<fs::path> dependencies{};
+		for (const auto& path : invocation.implicit_dependencies) {
+			dependencies.push_back(fs::absolute(fs::weakly_canonical(path)));
+		}
+
+		// relative entries are relative to the report, same as Insertable::extractDependenciesFromReport
+		for (const auto& line : dependency_report) {
+			fs::path path{ line };
+			if (!path.is_absolute()) {
+				path = invocation.dependency_report.parent_path() / path;
+			}
+			dependencies.push_back(fs::absolute(fs::weakly_canonical(path)));
+		}
+
+		std::sort(dependencies.begin(), dependencies.end());
+		dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+		return dependencies;
+	}
+
+	std::optional<AsarCache::Result> AsarCache::lookup(const Invocation& invocation, std::span<const char> rom) {
+		rom_before_hash = Hasher::hash(rom);
+		auto result{ find(invocation, rom.size()) };
+		if (!result.has_value()) {
+			// only needed to diff against once asar has run
+			rom_before.assign(rom.begin(), rom.end());
+		}
+		return result;
+	}
+
+	std::optional<AsarCache::Result> AsarCache::find(const Invocation& invocation, size_t rom_size) const {
+		const auto identity{ identify(invocation) };
+		const auto manifest{ store.get(MANIFEST_KIND, identity) };
+		if (!manifest.has_value()) {
+			return {};
+		}
+
+		std::vector<fs::path> dependencies{};
+		std::istringstream manifest_stream{ manifest.value() };
+		std::string line;
+		while (std::getline(manifest_stream, line)) {
+			dependencies.push_back(PathUtil::fromPortable(line, project_root));
+		}
+
+		const auto key{ resultKey(identity, dependencies) };
+		if (!key.has_value()) {
+			return {};
+		}
+
+		const auto serialized{ store.get(RESULT_KIND, key.value()) };
+		if (!serialized.has_value()) {
+			return {};
+		}
+
+		try {
+			auto result{ deserialize(serialized.value()) };
+			if (result.delta.getSizeBefore() != rom_size) {
+				return {};
+			}
+			spdlog::debug("Found cached asar result {} for {}", Hasher::toHex(key.value()), invocation.source);
+			return result;
+		}
+		catch (const CallistoException& e) {
+			spdlog::debug("Ignoring unreadable cached asar result {}: {}", Hasher::toHex(key.value()), e.what());
+			return {};
+		}
+	}
+
+	void AsarCache::record(const Invocation& invocation, std::span<const char> rom_after) {
+		Result result{};
+
+		std::ifstream report_file{ invocation.dependency_report };
+		if (!report_file) {
+			// can't tell what the patch read, so it can't be cached
+			return;
+		}
+		std::vector<std::string> report_lines{};
+		std::string line;
+		while (std::getline(report_file, line)) {
+			report_lines.push_back(line);
+		}
+		report_file.close();
+
+		// relative entries are relative to the report, same as Insertable::extractDependenciesFromReport
+		for (const auto& report_line : report_lines) {
+			fs::path path{ report_line };
+			if (!path.is_absolute()) {
+				path = invocation.dependency_report.parent_path() / path;
+			}
+			result.dependency_report.push_back(PathUtil::toPortable(fs::absolute(fs::weakly_canonical(path)), project_root));
+		}
+
+		result.delta = RomDelta::between(rom_before, rom_after);
+
+		int block_count{};
+		const auto written_blocks{ asar_getwrittenblocks(&block_count) };
+		for (int i{ 0 }; i != block_count; ++i) {
+			result.written_blocks.push_back({ written_blocks[i].pcoffset, written_blocks[i].numbytes });
+		}
+
+		result.labels = getAsarLabels();
+
+		int print_count{};
+		const auto prints{ asar_getprints(&print_count) };
+		for (int i{ 0 }; i != print_count; ++i) {
+			result.prints.push_back(prints[i]);
+		}
+
+		int warning_count{};
+		const auto warnings{ asar_getwarnings(&warning_count) };
+		for (int i{ 0 }; i != warning_count; ++i) {
+			result.warnings.push_back({ warnings[i].errid, warnings[i].fullerrdata });
+		}
+
+		const auto dependencies{ resolveDependencies(invocation, report_lines) };
+		const auto identity{ identify(invocation) };
+		const auto key{ resultKey(identity, dependencies) };
+		if (!key.has_value()) {
+			return;
+		}
+
+		std::ostringstream manifest{};
+		for (const auto& dependency : dependencies) {
+			manifest << PathUtil::toPortable(dependency, project_root) << '\n';
+		}
+
+		// result first, so a manifest never points at something that isn't there
+		store.put(RESULT_KIND, key.value(), serialize(result));
+		store.put(MANIFEST_KIND, identity, manifest.str());
+		spdlog::debug("Cached asar result {} for {}", Hasher::toHex(key.value()), invocation.source);
+	}
+
+	void AsarCache::restoreDependencyReport(const Invocation& invocation, const Result& result) const {
+		std::ofstream report_file{ invocation.dependency_report };
+		for (const auto& line : result.dependency_report) {
+			report_file << PathUtil::fromPortable(line, project_root).string() << '\n';
+		}
+	}
+
+	std::vector<AsarCache::Label> AsarCache::getAsarLabels() {
+		int label_count{};
+		const auto labels{ asar_getalllabels(&label_count) };
+
+		std::vector<Label> converted{};
+		converted.reserve(label_count);
+		for (int i{ 0 }; i != label_count; ++i) {
+			converted.push_back({ labels[i].name, labels[i].location });
+		}
+		return converted;
+	}
+
+	std::string AsarCache::serialize(const Result& result) {
+		std::ostringstream out{};
+		BinaryWriter writer{ out };
+		writer.write<uint32_t>(FORMAT_VERSION);
+		result.delta.serialize(out);
+
+		writer.write<uint32_t>(static_cast<uint32_t>(result.written_blocks.size()));
+		for (const auto& [pc_offset, size] : result.written_blocks) {
+			writer.write<uint32_t>(static_cast<uint32_t>(pc_offset));
+			writer.write<uint32_t>(static_cast<uint32_t>(size));
+		}
+
+		writer.write<uint32_t>(static_cast<uint32_t>(result.labels.size()));
+		for (const auto& label : result.labels) {
+			writer.writeString(label.name);
+			writer.write<int32_t>(label.location);
+		}
+
+		writer.write<uint32_t>(static_cast<uint32_t>(result.prints.size()));
+		for (const auto& print : result.prints) {
+			writer.writeString(print);
+		}
+
+		writer.write<uint32_t>(static_cast<uint32_t>(result.warnings.size()));
+		for (const auto& warning : result.warnings) {
+			writer.write<int32_t>(warning.id);
+			writer.writeString(warning.message);
+		}
+
+		writer.write<uint32_t>(static_cast<uint32_t>(result.dependency_report.size()));
+		for (const auto& line : result.dependency_report) {
+			writer.writeString(line);
+		}
+
+		return out.str();
+	}
+
+	AsarCache::Result AsarCache::deserialize(const std::string& serialized) {
+		std::istringstream in{ serialized };
+		BinaryReader reader{ in, "Cached asar result" };
+		if (reader.read<uint32_t>() != FORMAT_VERSION) {
+			throw CallistoException("Cached asar result format has changed");
+		}
+
+		Result result{};
+		result.delta = RomDelta::deserialize(in);
+
+		const auto block_count{ reader.read<uint32_t>() };
+		for (uint32_t i{ 0 }; i != block_count; ++i) {
+			const auto pc_offset{ reader.read<uint32_t>() };
+			const auto size{ reader.read<uint32_t>() };
+			result.written_blocks.push_back({ pc_offset, size });
+		}
+
+		const auto label_count{ reader.read<uint32_t>() };
+		for (uint32_t i{ 0 }; i != label_count; ++i) {
+			auto name{ reader.readString() };
+			const auto location{ reader.read<int32_t>() };
+			result.labels.push_back({ std::move(name), location });
+		}
+
+		const auto print_count{ reader.read<uint32_t>() };
+		for (uint32_t i{ 0 }; i != print_count; ++i) {
+			result.prints.push_back(reader.readString());
+		}
+
+		const auto warning_count{ reader.read<uint32_t>() };
+		for (uint32_t i{ 0 }; i != warning_count; ++i) {
+			const auto id{ reader.read<int32_t>() };
+			result.warnings.push_back({ id, reader.readString() });
+		}
+
+		const auto line_count{ reader.read<uint32_t>() };
+		for (uint32_t i{ 0 }; i != line_count; ++i) {
+			result.dependency_report.push_back(reader.readString());
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <optional>
+#include <span>
+#include <utility>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+
+#include <asar-dll-bindings/c/asardll.h>
+#include <spdlog/spdlog.h>
+
+#include "hasher.h"
+#include "content_store.h"
+#include "../rom/rom_delta.h"
+#include "../path_util.h"
+#include "../binary_io.h"
+
+namespace fs = std::filesystem;
+
+namespace callisto {
+	// Remembers what asar did to the ROM for a given patch, so the patch doesn't have to be assembled again
+	// as long as neither its sources nor the ROM going into it have changed
+	//
+	// Which files a patch reads is only known after assembling it, so entries are found in two steps, a
+	// manifest keyed on the invocation lists the files the last assembly read, the result is keyed on
+	// the invocation, those files' contents and the ROM, the latter being a stand-in for whatever bytes
+	// the patch may have read from it
+	//
+	// Paths are keyed relative to the project root, so results can be shared between clones of a project
+	class AsarCache {
+	public:
+		static constexpr uint32_t FORMAT_VERSION{ 3 };
+
+		// Everything about an asar call except the files it reads and the ROM it's applied to
+		struct Invocation {
+			// Path of the patch or contents of the in-memory patch passed to asar
+			std::string source;
+			std::vector<fs::path> include_paths;
+			std::vector<std::pair<std::string, std::string>> defines;
+			// Files that are known to be read without asar reporting them
+			std::vector<fs::path> implicit_dependencies;
+			// Where asar writes its list of included files
+			fs::path dependency_report;
+		};
+
+		struct Label {
+			std::string name;
+			int location;
+		};
+
+		struct Warning {
+			int id;
+			std::string message;
+		};
+
+		struct Result {
+			RomDelta delta;
+			// [pc offset, size) as reported by asar, these include writes that didn't change anything
+			std::vector<std::pair<size_t, size_t>> written_blocks;
+			std::vector<Label> labels;
+			std::vector<std::string> prints;
+			std::vector<Warning> warnings;
+			// Portable paths of the files asar reported, see PathUtil::toPortable
+			std::vector<std::string> dependency_report;
+		};
+
+	protected:
+		static constexpr auto MANIFEST_KIND{ "asar_manifests" };
+		static constexpr auto RESULT_KIND{ "asar_results" };
+
+		const ContentStore store;
+		const fs::path project_root;
+
+		// state of the ROM before the last lookup, only copied once it missed
+		std::vector<char> rom_before{};
+		Hasher::Hash rom_before_hash{};
+
+		Hasher::Hash identify(const Invocation& invocation) const;
+		std::optional<Result> find(const Invocation& invocation, size_t rom_size) const;
+		std::optional<Hasher::Hash> resultKey(Hasher::Hash identity, const std::vector<fs::path>& dependencies) const;
+
+		static std::vector<fs::path> resolveDependencies(const Invocation& invocation, const std::vector<std::string>& dependency_report);
+
+		static std::string serialize(const Result& result);
+		static Result deserialize(const std::string& serialized);
+
+	public:
+		// The store is shared with StepCache, which also takes care of evicting from it
+		AsarCache(const fs::path& store_root, const fs::path& project_root,
+			const std::optional<fs::path>& shared_store_root = {});
+
+		// On a hit, the result can be replayed in place of calling asar
+		std::optional<Result> lookup(const Invocation& invocation, std::span<const char> rom);
+
+		// Stores what the last successful asar call did, must follow a missed lookup for the same invocation
+		void record(const Invocation& invocation, std::span<const char> rom_after);
+
+		// Writes the dependency report back to where asar would have put it
+		void restoreDependencyReport(const Invocation& invocation, const Result& result) const;
+
+		static std::vector<Label> getAsarLabels();
+	};
+}
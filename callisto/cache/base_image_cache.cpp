@@ -0,0 +1,73 @@
+#include "base_image_cache.h"
+
+namespace callisto {
+	BaseImageCache::BaseImageCache(const fs::path& store_root) : store(store_root) {}
+
+	Hasher::Hash BaseImageCache::imageKey(Hasher::Hash clean_rom_hash, Hasher::Hash patch_hash) {
+		Hasher hasher{};
+		hasher.updateValue(FORMAT_VERSION);
+		hasher.updateValue(clean_rom_hash);
+		hasher.updateValue(patch_hash);
+		return hasher.digest();
+	}
+
+	void BaseImageCache::cloneFile(const fs::path& source, const fs::path& target) {
+		std::error_code error{};
+		fs::remove(target, error);
+
+#if defined(__linux__)
+		const auto source_fd{ open(source.c_str(), O_RDONLY) };
+		if (source_fd != -1) {
+			const auto target_fd{ open(target.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) };
+			const auto cloned{ target_fd != -1 && ioctl(target_fd, FICLONE, source_fd) == 0 };
+			if (target_fd != -1) {
+				close(target_fd);
+			}
+			close(source_fd);
+			if (cloned) {
+				return;
+			}
+		}
+#elif defined(__APPLE__)
+		if (clonefile(source.c_str(), target.c_str(), 0) == 0) {
+			return;
+		}
+#endif
+
+		fs::copy_file(source, target, fs::copy_options::overwrite_existing);
+	}
+
+	bool BaseImageCache::isVerifiedCleanRom(Hasher::Hash clean_rom_hash) const {
+		return store.locate(VERIFIED_KIND, clean_rom_hash).has_value();
+	}
+
+	void BaseImageCache::markVerifiedCleanRom(Hasher::Hash clean_rom_hash) const {
+		store.put(VERIFIED_KIND, clean_rom_hash, "");
+	}
+
+	bool BaseImageCache::restore(Hasher::Hash clean_rom_hash, Hasher::Hash patch_hash, const fs::path& target) const {
+		const auto key{ imageKey(clean_rom_hash, patch_hash) };
+		const auto image{ store.locate(IMAGE_KIND, key) };
+		if (!image.has_value()) {
+			return false;
+		}
+
+		cloneFile(image.value(), target);
+		spdlog::debug("Restored base image {}", Hasher::toHex(key));
+		return true;
+	}
+
+	void BaseImageCache::record(Hasher::Hash clean_rom_hash, Hasher::Hash patch_hash, const fs::path& image) const {
+		std::ifstream image_file{ image, std::ios::in | std::ios::binary };
+		const std::string contents{ std::istreambuf_iterator<char>(image_file), std::istreambuf_iterator<char>() };
+		if (!image_file) {
+			throw CallistoException(fmt::format("Failed to read base image {}", image.string()));
+		}
+
+		const auto key{ imageKey(clean_rom_hash, patch_hash) };
+		store.put(IMAGE_KIND, key, contents);
+		spdlog::debug("Cached base image {}", Hasher::toHex(key));
+
+		store.evict(MAX_SIZE);
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#include <spdlog/spdlog.h>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#elif defined(__APPLE__)
+#include <sys/clonefile.h>
+#endif
+
+#include "hasher.h"
+#include "content_store.h"
+
+namespace fs = std::filesystem;
+
+namespace callisto {
+	// ROMs with the initial patch applied, shared by all projects of a user since most of them
+	// start from the same clean ROM and a handful of initial patches, so FLIPS only has to run
+	// once per combination of them
+	//
+	// patch_hash stands for whatever was done to the clean ROM, usually the initial patch's hash
+	//
+	// Also remembers which clean ROMs have already passed Builder::checkCleanRom
+	class BaseImageCache {
+	public:
+		static constexpr uint32_t FORMAT_VERSION{ 1 };
+		// a base image is a few MB, this fits a good number of them
+		static constexpr uintmax_t MAX_SIZE{ 64 * 1024 * 1024 };
+
+	protected:
+		static constexpr auto IMAGE_KIND{ "images" };
+		static constexpr auto VERIFIED_KIND{ "verified_clean_roms" };
+
+		const ContentStore store;
+
+		static Hasher::Hash imageKey(Hasher::Hash clean_rom_hash, Hasher::Hash patch_hash);
+		// Copy on write clone where the file system supports it, a plain copy otherwise, a hard link
+		// would be cheaper still, but the temporary ROM is written to in place by most tools
+		static void cloneFile(const fs::path& source, const fs::path& target);
+
+	public:
+		BaseImageCache(const fs::path& store_root);
+
+		bool isVerifiedCleanRom(Hasher::Hash clean_rom_hash) const;
+		void markVerifiedCleanRom(Hasher::Hash clean_rom_hash) const;
+
+		// Returns whether a cached image was put at target
+		bool restore(Hasher::Hash clean_rom_hash, Hasher::Hash patch_hash, const fs::path& target) const;
+		void record(Hasher::Hash clean_rom_hash, Hasher::Hash patch_hash, const fs::path& image) const;
+	};
+}
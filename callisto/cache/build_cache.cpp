@@ -0,0 +1,183 @@
+#include "build_cache.h"
+
+namespace callisto {
+	namespace {
+		void writeFiles(BinaryWriter& writer, const std::vector<std::pair<fs::path, std::string>>& files) {
+			writer.write<uint32_t>(static_cast<uint32_t>(files.size()));
+			for (const auto& [path, contents] : files) {
+				writer.writeString(path.generic_string());
+				writer.writeString(contents);
+			}
+		}
+
+		std::vector<std::pair<fs::path, std::string>> readFiles(BinaryReader& reader) {
+			std::vector<std::pair<fs::path, std::string>> files{};
+			const auto file_count{ reader.read<uint32_t>() };
+			for (uint32_t i{ 0 }; i != file_count; ++i) {
+				fs::path path{ reader.readString() };
+				files.push_back({ std::move(path), reader.readString() });
+			}
+			return files;
+		}
+	}
+
+	BuildCache::BuildCache(const fs::path& store_root, const fs::path& project_root, uintmax_t max_size,
+		const std::optional<fs::path>& shared_store_root) 
+		: store(store_root, shared_store_root), project_root(project_root), max_size(max_size) {}
+
+	std::vector<std::vector<fs::path>> BuildCache::readManifest(Hasher::Hash identity) const {
+		std::vector<std::vector<fs::path>> dependency_sets{};
+
+		const auto manifest{ store.get(MANIFEST_KIND, identity) };
+		if (!manifest.has_value()) {
+			return dependency_sets;
+		}
+
+		// one path per line, sets are separated by an empty line
+		std::istringstream manifest_stream{ manifest.value() };
+		std::string line;
+		dependency_sets.emplace_back();
+		while (std::getline(manifest_stream, line)) {
+			if (line.empty()) {
+				dependency_sets.emplace_back();
+			}
+			else {
+				dependency_sets.back().push_back(PathUtil::fromPortable(line, project_root));
+			}
+		}
+
+		if (dependency_sets.back().empty()) {
+			dependency_sets.pop_back();
+		}
+		return dependency_sets;
+	}
+
+	Hasher::Hash BuildCache::buildKey(Hasher::Hash identity, const std::vector<fs::path>& dependencies,
+		FileHashes& file_hashes) const {
+		Hasher hasher{};
+		hasher.updateValue(FORMAT_VERSION);
+		hasher.updateValue(identity);
+
+		// folders are hashed by everything below them, Update treats any change inside them as a change too
+		std::vector<fs::path> files{};
+		for (const auto& dependency : dependencies) {
+			files.push_back(dependency);
+			if (fs::is_directory(dependency)) {
+				for (const auto& entry : fs::recursive_directory_iterator(dependency)) {
+					files.push_back(entry.path());
+				}
+			}
+		}
+		std::sort(files.begin(), files.end());
+		files.erase(std::unique(files.begin(), files.end()), files.end());
+
+		hasher.updateValue(files.size());
+		for (const auto& file : files) {
+			hasher.updateString(PathUtil::toPortable(file, project_root));
+
+			if (!fs::exists(file)) {
+				hasher.updateValue(0);
+			}
+			else if (fs::is_directory(file)) {
+				hasher.updateValue(1);
+			}
+			else {
+				hasher.updateValue(2);
+				const auto key{ file.string() };
+				if (file_hashes.count(key) == 0) {
+					file_hashes.insert({ key, Hasher::hashFile(file) });
+				}
+				hasher.updateValue(file_hashes.at(key));
+			}
+		}
+
+		return hasher.digest();
+	}
+
+	std::optional<BuildCache::Artifacts> BuildCache::lookup(Hasher::Hash identity) const {
+		FileHashes file_hashes{};
+		for (const auto& dependencies : readManifest(identity)) {
+			const auto key{ buildKey(identity, dependencies, file_hashes) };
+			const auto serialized{ store.get(BUILD_KIND, key) };
+			if (!serialized.has_value()) {
+				continue;
+			}
+
+			try {
+				auto artifacts{ deserialize(serialized.value()) };
+				spdlog::debug("Found cached build {}", Hasher::toHex(key));
+				return artifacts;
+			}
+			catch (const CallistoException& e) {
+				spdlog::debug("Ignoring unreadable cached build {}: {}", Hasher::toHex(key), e.what());
+			}
+		}
+
+		return {};
+	}
+
+	void BuildCache::record(Hasher::Hash identity, std::vector<fs::path> dependencies, const Artifacts& artifacts) const {
+		std::sort(dependencies.begin(), dependencies.end());
+		dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+
+		FileHashes file_hashes{};
+		const auto key{ buildKey(identity, dependencies, file_hashes) };
+
+		// build first, so a manifest never points at something that isn't there
+		store.put(BUILD_KIND, key, serialize(artifacts));
+
+		auto dependency_sets{ readManifest(identity) };
+		dependency_sets.erase(std::remove(dependency_sets.begin(), dependency_sets.end(), dependencies), dependency_sets.end());
+		dependency_sets.insert(dependency_sets.begin(), dependencies);
+		if (dependency_sets.size() > MAX_DEPENDENCY_SETS) {
+			dependency_sets.resize(MAX_DEPENDENCY_SETS);
+		}
+
+		std::ostringstream manifest{};
+		for (const auto& dependency_set : dependency_sets) {
+			for (const auto& dependency : dependency_set) {
+				manifest << PathUtil::toPortable(dependency, project_root) << '\n';
+			}
+			manifest << '\n';
+		}
+		store.put(MANIFEST_KIND, identity, manifest.str());
+		spdlog::debug("Cached build {}", Hasher::toHex(key));
+
+		store.evict(max_size);
+	}
+
+	std::string BuildCache::serialize(const Artifacts& artifacts) {
+		std::ostringstream out{};
+		BinaryWriter writer{ out };
+		writer.write<uint32_t>(FORMAT_VERSION);
+
+		writer.write<uint32_t>(static_cast<uint32_t>(artifacts.directories.size()));
+		for (const auto& directory : artifacts.directories) {
+			writer.writeString(directory.generic_string());
+		}
+
+		writeFiles(writer, artifacts.project_files);
+		writeFiles(writer, artifacts.rom_files);
+
+		return out.str();
+	}
+
+	BuildCache::Artifacts BuildCache::deserialize(const std::string& serialized) {
+		std::istringstream in{ serialized };
+		BinaryReader reader{ in, "Cached build" };
+		if (reader.read<uint32_t>() != FORMAT_VERSION) {
+			throw CallistoException("Cached build format has changed");
+		}
+
+		Artifacts artifacts{};
+		const auto directory_count{ reader.read<uint32_t>() };
+		for (uint32_t i{ 0 }; i != directory_count; ++i) {
+			artifacts.directories.push_back(fs::path(reader.readString()));
+		}
+
+		artifacts.project_files = readFiles(reader);
+		artifacts.rom_files = readFiles(reader);
+
+		return artifacts;
+	}
+}
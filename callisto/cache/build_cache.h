@@ -0,0 +1,73 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <optional>
+#include <utility>
+#include <unordered_map>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "hasher.h"
+#include "content_store.h"
+#include "../path_util.h"
+#include "../binary_io.h"
+
+namespace fs = std::filesystem;
+
+namespace callisto {
+	// Remembers the outputs of whole rebuilds, so a rebuild whose configuration and resources match
+	// an earlier one can restore that one's outputs instead of building again
+	//
+	// Which resources a build depends on is only known from its build report, so a manifest keyed
+	// on the configuration lists the dependency sets of the last few builds made with it, each one
+	// is tried in turn, which keeps hits coming when switching back and forth between branches
+	//
+	// Dependencies are keyed relative to the project root, so a build made in one clone of a project
+	// can be restored in another, e.g. through a shared cache directory
+	class BuildCache {
+	public:
+		static constexpr uint32_t FORMAT_VERSION{ 2 };
+		static constexpr size_t MAX_DEPENDENCY_SETS{ 8 };
+
+		struct Artifacts {
+			// Relative to the project root, replaced as a whole on restore
+			std::vector<fs::path> directories;
+			// Relative to the project root
+			std::vector<std::pair<fs::path, std::string>> project_files;
+			// The temporary ROM and whatever Lunar Magic put next to it, by file name
+			std::vector<std::pair<fs::path, std::string>> rom_files;
+		};
+
+	protected:
+		static constexpr auto MANIFEST_KIND{ "build_manifests" };
+		static constexpr auto BUILD_KIND{ "builds" };
+
+		const ContentStore store;
+		const fs::path project_root;
+		const uintmax_t max_size;
+
+		using FileHashes = std::unordered_map<std::string, Hasher::Hash>;
+
+		std::vector<std::vector<fs::path>> readManifest(Hasher::Hash identity) const;
+		Hasher::Hash buildKey(Hasher::Hash identity, const std::vector<fs::path>& dependencies,
+			FileHashes& file_hashes) const;
+
+		static std::string serialize(const Artifacts& artifacts);
+		static Artifacts deserialize(const std::string& serialized);
+
+	public:
+		BuildCache(const fs::path& store_root, const fs::path& project_root, uintmax_t max_size,
+			const std::optional<fs::path>& shared_store_root = {});
+
+		// identity stands for everything about a build that's known before building, usually the configuration
+		std::optional<Artifacts> lookup(Hasher::Hash identity) const;
+
+		// Stores a finished build and evicts old ones if the store has grown past its maximum size
+		void record(Hasher::Hash identity, std::vector<fs::path> dependencies, const Artifacts& artifacts) const;
+	};
+}
@@ -0,0 +1,71 @@
+#include "build_journal.h"
+
+namespace callisto {
+	BuildJournal::BuildJournal(const fs::path& path, Hasher::Hash chain_root) : path(path), chain_root(chain_root) {}
+
+	std::optional<BuildJournal> BuildJournal::read(const fs::path& path) {
+		if (!fs::exists(path)) {
+			return {};
+		}
+
+		try {
+			std::ifstream journal_file{ path };
+			const json j = json::parse(journal_file);
+			if (j.value("file_format_version", 0u) != FORMAT_VERSION) {
+				throw CallistoException("Build journal was written by a different version of callisto");
+			}
+
+			BuildJournal journal{ path, std::stoull(j["chain_root"].get<std::string>(), nullptr, 16) };
+			for (const auto& entry : j["steps"]) {
+				journal.entries.push_back({ entry["descriptor"].get<std::string>(),
+					std::stoull(entry["fingerprint"].get<std::string>(), nullptr, 16) });
+			}
+			if (!j["failed_step"].is_null()) {
+				journal.failed_step = j["failed_step"].get<std::string>();
+			}
+			return journal;
+		}
+		catch (const std::exception& e) {
+			spdlog::debug("Ignoring unreadable build journal: {}", e.what());
+			return {};
+		}
+	}
+
+	void BuildJournal::write() const {
+		json j{};
+		j["file_format_version"] = FORMAT_VERSION;
+		j["chain_root"] = Hasher::toHex(chain_root);
+
+		j["steps"] = json::array();
+		for (const auto& entry : entries) {
+			j["steps"].push_back({
+				{ "descriptor", entry.step },
+				{ "fingerprint", Hasher::toHex(entry.fingerprint) }
+			});
+		}
+		j["failed_step"] = failed_step.has_value() ? json(failed_step.value()) : json(nullptr);
+
+		fs::create_directories(path.parent_path());
+		std::ofstream journal_file{ path };
+		journal_file << std::setw(4) << j << std::endl;
+		if (!journal_file) {
+			throw CallistoException(fmt::format("Failed to write build journal to {}", path.string()));
+		}
+	}
+
+	void BuildJournal::begin(std::vector<Entry> kept_entries) {
+		entries = std::move(kept_entries);
+		failed_step.reset();
+		write();
+	}
+
+	void BuildJournal::append(const std::string& step, Hasher::Hash fingerprint) {
+		entries.push_back({ step, fingerprint });
+		write();
+	}
+
+	void BuildJournal::fail(const std::string& step) {
+		failed_step = step;
+		write();
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <optional>
+#include <fstream>
+#include <iomanip>
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include "hasher.h"
+#include "../callisto_exception.h"
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+
+namespace callisto {
+	// Record of the steps the last rebuild got through, rewritten after each one, together with the
+	// checkpoints in CheckpointStore this is what rebuild --resume continues from
+	//
+	// Each entry holds the step's descriptor and the fingerprint of its checkpoint, resuming checks
+	// every entry against the current build order and inputs and continues at the first one that doesn't match
+	class BuildJournal {
+	public:
+		static constexpr uint32_t FORMAT_VERSION{ 1 };
+
+		struct Entry {
+			// The step's descriptor as it appears in the build report
+			std::string step;
+			Hasher::Hash fingerprint;
+		};
+
+	protected:
+		fs::path path;
+		Hasher::Hash chain_root;
+		std::vector<Entry> entries{};
+		std::optional<std::string> failed_step{};
+
+		void write() const;
+
+	public:
+		BuildJournal(const fs::path& path, Hasher::Hash chain_root);
+
+		// Empty if there is no journal or it can't be read
+		static std::optional<BuildJournal> read(const fs::path& path);
+
+		Hasher::Hash getChainRoot() const {
+			return chain_root;
+		}
+
+		const std::vector<Entry>& getEntries() const {
+			return entries;
+		}
+
+		const std::optional<std::string>& getFailedStep() const {
+			return failed_step;
+		}
+
+		// Starts a new journal that keeps the given entries, e.g. the steps a rebuild resumed after
+		void begin(std::vector<Entry> kept_entries);
+		void append(const std::string& step, Hasher::Hash fingerprint);
+		void fail(const std::string& step);
+	};
+}
@@ -0,0 +1,99 @@
+#include "checkpoint_store.h"
+
+namespace callisto {
+	CheckpointStore::CheckpointStore(const fs::path& store_root, uintmax_t max_size) : store(store_root), max_size(max_size) {}
+
+	Hasher::Hash CheckpointStore::manifestKey(Hasher::Hash previous, const std::string& step) {
+		Hasher hasher{};
+		hasher.updateValue(FORMAT_VERSION);
+		hasher.updateValue(previous);
+		hasher.updateString(step);
+		return hasher.digest();
+	}
+
+	// most files don't change from one step to the next, so they're only stored once
+	Hasher::Hash CheckpointStore::putFile(std::string_view contents) {
+		const auto key{ Hasher::hash({ contents.data(), contents.size() }) };
+		if (stored_files.insert(key).second) {
+			store.putContentAddressed(FILE_KIND, key, contents);
+		}
+		return key;
+	}
+
+	std::optional<std::string> CheckpointStore::getFile(Hasher::Hash key) const {
+		auto contents{ store.get(FILE_KIND, key) };
+		if (contents.has_value() && Hasher::hash({ contents.value().data(), contents.value().size() }) != key) {
+			spdlog::debug("Ignoring corrupted checkpoint file {}", Hasher::toHex(key));
+			return {};
+		}
+		return contents;
+	}
+
+	std::optional<std::string> CheckpointStore::getManifest(Hasher::Hash previous, const std::string& step) const {
+		return store.get(MANIFEST_KIND, manifestKey(previous, step));
+	}
+
+	bool CheckpointStore::contains(Hasher::Hash fingerprint) const {
+		return store.contains(CHECKPOINT_KIND, fingerprint);
+	}
+
+	std::optional<CheckpointStore::Checkpoint> CheckpointStore::get(Hasher::Hash fingerprint) const {
+		const auto serialized{ store.get(CHECKPOINT_KIND, fingerprint) };
+		if (!serialized.has_value()) {
+			return {};
+		}
+
+		try {
+			std::istringstream in{ serialized.value() };
+			BinaryReader reader{ in, "Checkpoint" };
+			if (reader.read<uint32_t>() != FORMAT_VERSION) {
+				throw CallistoException("Checkpoint format has changed");
+			}
+
+			Checkpoint checkpoint{};
+			checkpoint.delta = RomDelta::deserialize(in);
+
+			const auto file_count{ reader.read<uint32_t>() };
+			for (uint32_t i{ 0 }; i != file_count; ++i) {
+				auto path{ reader.readString() };
+				const auto contents{ getFile(reader.read<Hasher::Hash>()) };
+				if (!contents.has_value()) {
+					return {};
+				}
+				checkpoint.files.push_back({ std::move(path), contents.value() });
+			}
+
+			checkpoint.report_entry = reader.readString();
+			return checkpoint;
+		}
+		catch (const CallistoException& e) {
+			spdlog::debug("Ignoring unreadable checkpoint {}: {}", Hasher::toHex(fingerprint), e.what());
+			return {};
+		}
+	}
+
+	void CheckpointStore::record(Hasher::Hash previous, const std::string& step, Hasher::Hash fingerprint,
+		const RomDelta& delta, const std::vector<std::pair<std::string, Hasher::Hash>>& files, const std::string& report_entry) {
+		std::ostringstream out{};
+		BinaryWriter writer{ out };
+		writer.write<uint32_t>(FORMAT_VERSION);
+		delta.serialize(out);
+
+		writer.write<uint32_t>(static_cast<uint32_t>(files.size()));
+		for (const auto& [path, key] : files) {
+			writer.writeString(path);
+			writer.write<Hasher::Hash>(key);
+		}
+
+		writer.writeString(report_entry);
+
+		// checkpoint first, so a manifest never points at something that isn't there
+		store.put(CHECKPOINT_KIND, fingerprint, out.str());
+		store.put(MANIFEST_KIND, manifestKey(previous, step), report_entry);
+		spdlog::debug("Recorded checkpoint {}", Hasher::toHex(fingerprint));
+	}
+
+	void CheckpointStore::evict() const {
+		store.evict(max_size);
+	}
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <optional>
+#include <utility>
+#include <unordered_set>
+#include <sstream>
+
+#include <spdlog/spdlog.h>
+
+#include "hasher.h"
+#include "content_store.h"
+#include "../rom/rom_delta.h"
+#include "../binary_io.h"
+
+namespace fs = std::filesystem;
+
+namespace callisto {
+	// Snapshots of the build taken after each step of a rebuild, so a later rebuild can pick up
+	// after the last step whose inputs haven't changed instead of starting over from the clean ROM
+	//
+	// Checkpoints are keyed on a fingerprint chained through all steps up to them, each one only holds
+	// what its step changed about the ROM, so the ROM at a checkpoint is the clean ROM with the changes
+	// of all checkpoints up to it replayed, files are stored once no matter how many checkpoints contain them
+	//
+	// What a step depended on is only known after running it, so like in StepCache, a manifest keyed
+	// on the previous checkpoint and the step holds its last build report entry to fingerprint it by
+	class CheckpointStore {
+	public:
+		static constexpr uint32_t FORMAT_VERSION{ 1 };
+
+		struct Checkpoint {
+			// From the previous checkpoint's ROM, or the clean ROM for the first step
+			RomDelta delta;
+			// Portable path and contents of the files the build had produced at this point, see PathUtil::toPortable
+			std::vector<std::pair<std::string, std::string>> files;
+			// The step's entry in the build report
+			std::string report_entry;
+		};
+
+	protected:
+		static constexpr auto MANIFEST_KIND{ "checkpoint_manifests" };
+		static constexpr auto CHECKPOINT_KIND{ "checkpoints" };
+		static constexpr auto FILE_KIND{ "checkpoint_files" };
+
+		const ContentStore store;
+		const uintmax_t max_size;
+
+		// files known to be in the store already, saves looking for them again on every checkpoint
+		std::unordered_set<Hasher::Hash> stored_files{};
+
+		static Hasher::Hash manifestKey(Hasher::Hash previous, const std::string& step);
+		std::optional<std::string> getFile(Hasher::Hash key) const;
+
+	public:
+		CheckpointStore(const fs::path& store_root, uintmax_t max_size);
+
+		// The report entry the step had when it last ran after the given checkpoint
+		std::optional<std::string> getManifest(Hasher::Hash previous, const std::string& step) const;
+
+		bool contains(Hasher::Hash fingerprint) const;
+		// Empty if the checkpoint or any part of it has been evicted
+		std::optional<Checkpoint> get(Hasher::Hash fingerprint) const;
+
+		// Stores a file for checkpoints to refer to by the returned hash, files are only stored once
+		Hasher::Hash putFile(std::string_view contents);
+
+		// files are portable paths and the hashes putFile returned for their contents
+		void record(Hasher::Hash previous, const std::string& step, Hasher::Hash fingerprint, const RomDelta& delta,
+			const std::vector<std::pair<std::string, Hasher::Hash>>& files, const std::string& report_entry);
+
+		// Removes least recently used checkpoints and files until the store fits its maximum size again
+		void evict() const;
+	};
+}
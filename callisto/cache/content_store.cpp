@@ -0,0 +1,146 @@
+#include "content_store.h"
+
+namespace callisto {
+	ContentStore::ContentStore(const fs::path& root, const std::optional<fs::path>& shared_root) 
+		: root(root), shared_root(shared_root) {}
+
+	fs::path ContentStore::objectPath(const fs::path& store_root, std::string_view kind, Hasher::Hash key) {
+		const auto name{ Hasher::toHex(key) };
+		return store_root / kind / name.substr(0, 2) / name;
+	}
+
+	std::optional<std::string> ContentStore::read(const fs::path& path) {
+		std::ifstream object_file{ path, std::ios::in | std::ios::binary };
+		if (!object_file) {
+			return {};
+		}
+		return std::string{ std::istreambuf_iterator<char>(object_file), std::istreambuf_iterator<char>() };
+	}
+
+	bool ContentStore::contains(std::string_view kind, Hasher::Hash key) const {
+		return fs::exists(objectPath(root, kind, key)) 
+			|| (shared_root.has_value() && fs::exists(objectPath(shared_root.value(), kind, key)));
+	}
+
+	std::optional<std::string> ContentStore::get(std::string_view kind, Hasher::Hash key) const {
+		const auto path{ objectPath(root, kind, key) };
+		auto contents{ read(path) };
+
+		if (contents.has_value()) {
+			// the write time doubles as the last use, failing to update it only makes eviction less accurate
+			std::error_code error{};
+			fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+		}
+		else if (shared_root.has_value()) {
+			contents = read(objectPath(shared_root.value(), kind, key));
+			if (contents.has_value()) {
+				spdlog::debug("Found cache object {} in shared cache", Hasher::toHex(key));
+				publish(root, kind, key, contents.value());
+			}
+		}
+
+		return contents;
+	}
+
+	std::optional<fs::path> ContentStore::locate(std::string_view kind, Hasher::Hash key) const {
+		const auto path{ objectPath(root, kind, key) };
+		if (!fs::exists(path)) {
+			if (!shared_root.has_value()) {
+				return {};
+			}
+			const auto contents{ read(objectPath(shared_root.value(), kind, key)) };
+			if (!contents.has_value()) {
+				return {};
+			}
+			spdlog::debug("Found cache object {} in shared cache", Hasher::toHex(key));
+			publish(root, kind, key, contents.value());
+			return path;
+		}
+
+		std::error_code error{};
+		fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+		return path;
+	}
+
+	void ContentStore::put(std::string_view kind, Hasher::Hash key, std::string_view contents) const {
+		publish(root, kind, key, contents);
+
+		if (shared_root.has_value() && !fs::exists(objectPath(shared_root.value(), kind, key))) {
+			// the shared cache is a nice to have, a read-only or unreachable one shouldn't fail the build
+			try {
+				publish(shared_root.value(), kind, key, contents);
+			}
+			catch (const std::exception& e) {
+				spdlog::debug("Failed to publish cache object {} to shared cache: {}", Hasher::toHex(key), e.what());
+			}
+		}
+	}
+
+	void ContentStore::putContentAddressed(std::string_view kind, Hasher::Hash key, std::string_view contents) const {
+		const auto path{ objectPath(root, kind, key) };
+		std::error_code error{};
+		if (fs::exists(path, error)) {
+			fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+			return;
+		}
+		put(kind, key, contents);
+	}
+
+	void ContentStore::publish(const fs::path& store_root, std::string_view kind, Hasher::Hash key, std::string_view contents) {
+		const auto target{ objectPath(store_root, kind, key) };
+		const auto staging_directory{ store_root / STAGING_DIRECTORY_NAME };
+		fs::create_directories(target.parent_path());
+		fs::create_directories(staging_directory);
+
+		// staged next to the target so the rename stays on one file system and is atomic, also on a shared drive
+		const auto staging_path{ staging_directory / boost::filesystem::unique_path().string() };
+		{
+			std::ofstream staging_file{ staging_path, std::ios::out | std::ios::binary };
+			staging_file.write(contents.data(), contents.size());
+			if (!staging_file) {
+				fs::remove(staging_path);
+				throw CallistoException(fmt::format("Failed to write cache object {}", target.string()));
+			}
+		}
+
+		std::error_code error{};
+		fs::rename(staging_path, target, error);
+		if (error) {
+			fs::remove(staging_path, error);
+			spdlog::debug("Failed to publish cache object {}, another process probably got there first", target.string());
+		}
+	}
+
+	void ContentStore::evict(uintmax_t max_size) const {
+		if (!fs::exists(root)) {
+			return;
+		}
+
+		std::vector<std::tuple<fs::file_time_type, uintmax_t, fs::path>> objects{};
+		uintmax_t total_size{ 0 };
+		for (auto it{ fs::recursive_directory_iterator(root) }; it != fs::recursive_directory_iterator(); ++it) {
+			if (it->path().filename() == STAGING_DIRECTORY_NAME) {
+				it.disable_recursion_pending();
+				continue;
+			}
+			if (it->is_regular_file()) {
+				const auto size{ it->file_size() };
+				objects.push_back({ it->last_write_time(), size, it->path() });
+				total_size += size;
+			}
+		}
+
+		std::sort(objects.begin(), objects.end());
+		for (const auto& [_, size, path] : objects) {
+			if (total_size <= max_size) {
+				break;
+			}
+
+			std::error_code error{};
+			if (fs::remove(path, error)) {
+				total_size -= size;
+				spdlog::debug("Evicted cache object {}", path.string());
+			}
+		}
+	}
+}
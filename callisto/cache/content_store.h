@@ -0,0 +1,62 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <tuple>
+#include <algorithm>
+#include <chrono>
+
+#include <boost/filesystem.hpp>
+#include <spdlog/spdlog.h>
+
+#include "hasher.h"
+
+namespace fs = std::filesystem;
+
+namespace callisto {
+	// Directory of objects named by their key, grouped by kind and fanned out by the first
+	// two hex digits so no single directory gets huge
+	//
+	// Objects are written to a staging file first and renamed into place, so readers (possibly
+	// other callisto processes) never see a partially written object
+	//
+	// Reading an object marks it as used, so eviction drops the objects that haven't been used the longest
+	//
+	// A store can be backed by a shared one, e.g. a directory on a network drive the whole team uses,
+	// objects missing locally are looked up there and copied over, new ones are published to both,
+	// the shared store is never evicted from since nobody knows who else still needs its objects
+	class ContentStore {
+	protected:
+		static constexpr auto STAGING_DIRECTORY_NAME{ ".staging" };
+
+		const fs::path root;
+		const std::optional<fs::path> shared_root;
+
+		static fs::path objectPath(const fs::path& store_root, std::string_view kind, Hasher::Hash key);
+		static std::optional<std::string> read(const fs::path& path);
+		static void publish(const fs::path& store_root, std::string_view kind, Hasher::Hash key, std::string_view contents);
+
+	public:
+		ContentStore(const fs::path& root, const std::optional<fs::path>& shared_root = {});
+
+		const fs::path& getRoot() const {
+			return root;
+		}
+
+		bool contains(std::string_view kind, Hasher::Hash key) const;
+		std::optional<std::string> get(std::string_view kind, Hasher::Hash key) const;
+		// Where the object is in the local store, for objects that are copied into place as a whole instead of read
+		std::optional<fs::path> locate(std::string_view kind, Hasher::Hash key) const;
+		void put(std::string_view kind, Hasher::Hash key, std::string_view contents) const;
+		// For objects keyed on their own contents, one that's already there is only marked as used
+		void putContentAddressed(std::string_view kind, Hasher::Hash key, std::string_view contents) const;
+
+		// Removes least recently used objects until the rest fit into max_size bytes
+		void evict(uintmax_t max_size) const;
+	};
+}
@@ -0,0 +1,318 @@
+#include "git_index.h"
+
+namespace callisto {
+	GitIndex::GitIndex(const fs::path& work_tree) : work_tree(work_tree), index_path(getGitDirectory(work_tree) / "index"),
+		object_id_size(getObjectIdSize(getGitDirectory(work_tree))) {
+		std::error_code error{};
+		index_file_time = fs::last_write_time(index_path, error);
+		if (error) {
+			throw UnreadableIndex(fmt::format("Failed to read git index {}", index_path.string()));
+		}
+		index_write_time = toTimestamp(index_file_time);
+
+		std::ifstream index_file{ index_path, std::ios::in | std::ios::binary };
+		const std::vector<char> index{ std::istreambuf_iterator<char>(index_file), std::istreambuf_iterator<char>() };
+		if (!index_file) {
+			throw UnreadableIndex(fmt::format("Failed to read git index {}", index_path.string()));
+		}
+
+		parse(index, object_id_size);
+		spdlog::debug("Read {} entries from git index {}", entries.size(), index_path.string());
+	}
+
+	std::optional<fs::path> GitIndex::findWorkTree(const fs::path& directory) {
+		std::error_code error{};
+		for (auto current{ directory }; ; current = current.parent_path()) {
+			if (fs::exists(current / ".git", error)) {
+				return current;
+			}
+			if (current == current.parent_path()) {
+				return {};
+			}
+		}
+	}
+
+	fs::path GitIndex::getGitDirectory(const fs::path& work_tree) {
+		const auto dot_git{ work_tree / ".git" };
+		if (fs::is_directory(dot_git)) {
+			return dot_git;
+		}
+
+		// linked worktrees and submodules have a file pointing to their git directory instead
+		std::ifstream dot_git_file{ dot_git };
+		std::string line{};
+		std::getline(dot_git_file, line);
+		constexpr std::string_view prefix{ "gitdir: " };
+		if (!line.starts_with(prefix)) {
+			throw UnreadableIndex(fmt::format("Unrecognized .git file {}", dot_git.string()));
+		}
+		while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+			line.pop_back();
+		}
+		return (work_tree / line.substr(prefix.size())).lexically_normal();
+	}
+
+	size_t GitIndex::getObjectIdSize(const fs::path& git_directory) {
+		std::vector<fs::path> config_paths{ git_directory / "config" };
+		std::ifstream common_directory_file{ git_directory / "commondir" };
+		std::string common_directory{};
+		if (std::getline(common_directory_file, common_directory)) {
+			config_paths.push_back(git_directory / common_directory / "config");
+		}
+
+		for (const auto& config_path : config_paths) {
+			std::ifstream config_file{ config_path };
+			std::string line{};
+			while (std::getline(config_file, line)) {
+				std::transform(line.begin(), line.end(), line.begin(), [](unsigned char c) { return std::tolower(c); });
+				if (line.find("objectformat") != std::string::npos && line.find("sha256") != std::string::npos) {
+					return SHA256_SIZE;
+				}
+			}
+		}
+		return SHA1_SIZE;
+	}
+
+	GitIndex::Timestamp GitIndex::toTimestamp(fs::file_time_type time) {
+#ifdef _WIN32
+		const auto system_time{ std::chrono::clock_cast<std::chrono::system_clock>(time) };
+#else
+		const auto system_time{ std::chrono::file_clock::to_sys(time) };
+#endif
+		const auto nanoseconds{ std::chrono::duration_cast<std::chrono::nanoseconds>(system_time.time_since_epoch()).count() };
+		return { static_cast<uint32_t>(nanoseconds / 1'000'000'000), static_cast<uint32_t>(nanoseconds % 1'000'000'000) };
+	}
+
+	uint32_t GitIndex::readUint32(const std::vector<char>& index, size_t offset) {
+		if (offset + 4 > index.size()) {
+			throw UnreadableIndex("Git index is truncated");
+		}
+		uint32_t value{ 0 };
+		for (size_t i{ 0 }; i != 4; ++i) {
+			value = (value << 8) | static_cast<uint8_t>(index[offset + i]);
+		}
+		return value;
+	}
+
+	uint16_t GitIndex::readUint16(const std::vector<char>& index, size_t offset) {
+		if (offset + 2 > index.size()) {
+			throw UnreadableIndex("Git index is truncated");
+		}
+		return static_cast<uint16_t>((static_cast<uint8_t>(index[offset]) << 8) | static_cast<uint8_t>(index[offset + 1]));
+	}
+
+	// Same encoding as offsets in packfiles, each continuation byte also adds one so no value has two encodings
+	size_t GitIndex::readOffset(const std::vector<char>& index, size_t& offset) {
+		if (offset >= index.size()) {
+			throw UnreadableIndex("Git index is truncated");
+		}
+		auto byte{ static_cast<uint8_t>(index[offset++]) };
+		size_t value{ byte & 0x7Fu };
+		while (byte & 0x80) {
+			if (offset >= index.size()) {
+				throw UnreadableIndex("Git index is truncated");
+			}
+			byte = static_cast<uint8_t>(index[offset++]);
+			value = ((value + 1) << 7) | (byte & 0x7Fu);
+		}
+		return value;
+	}
+
+	void GitIndex::parse(const std::vector<char>& index, size_t object_id_size) {
+		constexpr size_t header_size{ 12 };
+		constexpr size_t stat_size{ 40 };
+
+		if (index.size() < header_size + object_id_size || !std::equal(std::begin(SIGNATURE), std::end(SIGNATURE), index.begin())) {
+			throw UnreadableIndex(fmt::format("{} is not a git index", index_path.string()));
+		}
+		const auto version{ readUint32(index, 4) };
+		if (version < 2 || version > 4) {
+			throw UnreadableIndex(fmt::format("Unsupported git index version {}", version));
+		}
+		const auto entry_count{ readUint32(index, 8) };
+		// the index ends with a checksum of everything before it
+		const auto end{ index.size() - object_id_size };
+
+		size_t offset{ header_size };
+		std::string previous_path{};
+		for (uint32_t i{ 0 }; i != entry_count; ++i) {
+			const auto entry_start{ offset };
+			if (offset + stat_size + object_id_size + 2 > end) {
+				throw UnreadableIndex("Git index is truncated");
+			}
+
+			const Timestamp mtime{ readUint32(index, offset + 8), readUint32(index, offset + 12) };
+			const auto mode{ readUint32(index, offset + 24) };
+			const auto size{ readUint32(index, offset + 36) };
+			std::string blob_id{};
+			for (size_t j{ 0 }; j != object_id_size; ++j) {
+				blob_id += fmt::format("{:02x}", static_cast<uint8_t>(index[offset + stat_size + j]));
+			}
+			const auto flags{ readUint16(index, offset + stat_size + object_id_size) };
+			offset += stat_size + object_id_size + 2;
+
+			uint16_t extended_flags{ 0 };
+			if (flags & EXTENDED_FLAG) {
+				if (version < 3) {
+					throw UnreadableIndex("Extended flags in a version 2 git index");
+				}
+				extended_flags = readUint16(index, offset);
+				offset += 2;
+			}
+
+			std::string path{};
+			if (version == 4) {
+				// paths are stored as the part of the previous one to keep and what follows it
+				const auto strip{ readOffset(index, offset) };
+				if (strip > previous_path.size()) {
+					throw UnreadableIndex("Malformed path in git index");
+				}
+				path = previous_path.substr(0, previous_path.size() - strip);
+			}
+
+			const auto name_start{ offset };
+			const auto name_end{ std::find(index.begin() + name_start, index.begin() + end, '\0') };
+			if (name_end == index.begin() + end) {
+				throw UnreadableIndex("Git index is truncated");
+			}
+			path.append(index.begin() + name_start, name_end);
+			offset = name_end - index.begin() + 1;
+
+			if (version != 4) {
+				// entries are padded with 1 to 8 NULs to a multiple of 8 bytes
+				const auto name_length{ static_cast<size_t>(name_end - (index.begin() + name_start)) };
+				offset = entry_start + ((name_start - entry_start + name_length + 8) & ~size_t{ 7 });
+			}
+
+			const auto usable{ (flags & STAGE_MASK) == 0 &&
+				(extended_flags & (SKIP_WORKTREE_FLAG | INTENT_TO_ADD_FLAG)) == 0 &&
+				(mode & OBJECT_TYPE_MASK) == REGULAR_FILE_TYPE
+			};
+			if (usable) {
+				entries.insert({ path, { mtime, size, blob_id } });
+			}
+			previous_path = std::move(path);
+		}
+
+		while (offset + 8 <= end) {
+			if (std::string(index.begin() + offset, index.begin() + offset + 4) == "link") {
+				throw UnreadableIndex("Split git indexes are not supported");
+			}
+			offset += 8 + readUint32(index, offset + 4);
+		}
+	}
+
+	std::shared_ptr<const GitIndex> GitIndex::forPath(const fs::path& path) {
+		static std::mutex mutex{};
+		static std::unordered_map<std::string, std::optional<fs::path>> work_trees{};
+		static std::unordered_map<std::string, std::shared_ptr<const GitIndex>> indexes{};
+
+		std::error_code error{};
+		const auto directory{ fs::absolute(path, error).lexically_normal().parent_path() };
+		if (error) {
+			return nullptr;
+		}
+
+		std::lock_guard lock{ mutex };
+		auto work_tree{ work_trees.find(directory.string()) };
+		if (work_tree == work_trees.end()) {
+			work_tree = work_trees.insert({ directory.string(), findWorkTree(directory) }).first;
+		}
+		if (!work_tree->second.has_value()) {
+			return nullptr;
+		}
+
+		const auto key{ work_tree->second.value().string() };
+		const auto cached{ indexes.find(key) };
+		if (cached != indexes.end()) {
+			if (cached->second == nullptr) {
+				return nullptr;
+			}
+			if (fs::last_write_time(cached->second->index_path, error) == cached->second->index_file_time && !error) {
+				return cached->second;
+			}
+		}
+
+		std::shared_ptr<const GitIndex> index{};
+		try {
+			index = std::make_shared<const GitIndex>(work_tree->second.value());
+		}
+		catch (const std::exception& e) {
+			spdlog::debug("Not using git index of {}: {}", key, e.what());
+		}
+		indexes[key] = index;
+		return index;
+	}
+
+	std::optional<std::string> GitIndex::getCleanBlobId(const fs::path& path) {
+		const auto index{ forPath(path) };
+		if (index == nullptr) {
+			return {};
+		}
+		return index->getBlobId(path);
+	}
+
+	bool GitIndex::hasBlobContents(const fs::path& path, const std::string& blob_id) {
+		const auto index{ forPath(path) };
+		if (index == nullptr || !fs::is_regular_file(path)) {
+			return false;
+		}
+
+		std::ifstream file{ path, std::ios::in | std::ios::binary };
+		if (!file) {
+			return false;
+		}
+		const std::string contents{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+		if (GitObjectId::ofBlob(contents, index->object_id_size) == blob_id) {
+			return true;
+		}
+
+		// with core.autocrlf or a text attribute, git stores text files with LF line endings
+		if (contents.find("\r\n") == std::string::npos) {
+			return false;
+		}
+		std::string normalized{};
+		normalized.reserve(contents.size());
+		for (size_t i{ 0 }; i != contents.size(); ++i) {
+			if (contents[i] != '\r' || i + 1 == contents.size() || contents[i + 1] != '\n') {
+				normalized.push_back(contents[i]);
+			}
+		}
+		return GitObjectId::ofBlob(normalized, index->object_id_size) == blob_id;
+	}
+
+	std::optional<std::string> GitIndex::getBlobId(const fs::path& path) const {
+		std::error_code error{};
+		const auto relative{ fs::absolute(path, error).lexically_normal().lexically_relative(work_tree).generic_string() };
+		if (error || relative.empty() || relative.starts_with("..")) {
+			return {};
+		}
+
+		const auto entry{ entries.find(relative) };
+		if (entry == entries.end()) {
+			return {};
+		}
+
+		// racily clean, the file may have been written again right after git looked at it without its write time changing
+		if (entry->second.mtime >= index_write_time) {
+			return {};
+		}
+
+		const auto size{ fs::file_size(path, error) };
+		if (error || static_cast<uint32_t>(size) != entry->second.size) {
+			return {};
+		}
+		const auto write_time{ fs::last_write_time(path, error) };
+		if (error) {
+			return {};
+		}
+		// git built without nanosecond support records 0 and only compares seconds
+		const auto mtime{ toTimestamp(write_time) };
+		if (mtime.seconds != entry->second.mtime.seconds ||
+			(entry->second.mtime.nanoseconds != 0 && mtime.nanoseconds != entry->second.mtime.nanoseconds)) {
+			return {};
+		}
+
+		return entry->second.blob_id;
+	}
+}
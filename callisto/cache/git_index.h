@@ -0,0 +1,100 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <cctype>
+#include <optional>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include <system_error>
+
+#include <spdlog/spdlog.h>
+#include <fmt/format.h>
+
+#include "git_object_id.h"
+#include "../callisto_exception.h"
+
+namespace fs = std::filesystem;
+
+namespace callisto {
+	// Blob ids of the files git tracks, read straight from the index (versions 2 to 4), git already hashed
+	// all of them, so for a file whose write time and size still match its index entry the blob id is a
+	// content fingerprint that costs nothing to get
+	//
+	// Entries git itself couldn't trust are left out, that is racily clean ones (written in the same instant as
+	// the index), conflicted, skip-worktree and intent-to-add entries, symlinks and submodules, split indexes
+	// aren't read at all
+	class GitIndex {
+	protected:
+		static constexpr char SIGNATURE[]{ 'D', 'I', 'R', 'C' };
+		static constexpr size_t SHA1_SIZE{ 20 };
+		static constexpr size_t SHA256_SIZE{ 32 };
+		static constexpr uint16_t STAGE_MASK{ 0x3000 };
+		static constexpr uint16_t EXTENDED_FLAG{ 0x4000 };
+		static constexpr uint16_t NAME_MASK{ 0x0FFF };
+		static constexpr uint16_t SKIP_WORKTREE_FLAG{ 0x4000 };
+		static constexpr uint16_t INTENT_TO_ADD_FLAG{ 0x2000 };
+		static constexpr uint32_t OBJECT_TYPE_MASK{ 0170000 };
+		static constexpr uint32_t REGULAR_FILE_TYPE{ 0100000 };
+
+		struct Timestamp {
+			uint32_t seconds;
+			uint32_t nanoseconds;
+
+			auto operator<=>(const Timestamp&) const = default;
+		};
+
+		struct Entry {
+			Timestamp mtime;
+			// only the lower 32 bits, same as git
+			uint32_t size;
+			std::string blob_id;
+		};
+
+		class UnreadableIndex : public CallistoException {
+			using CallistoException::CallistoException;
+		};
+
+		const fs::path work_tree;
+		const fs::path index_path;
+		const size_t object_id_size;
+		fs::file_time_type index_file_time{};
+		Timestamp index_write_time{};
+		std::unordered_map<std::string, Entry> entries{};
+
+		static std::optional<fs::path> findWorkTree(const fs::path& directory);
+		static fs::path getGitDirectory(const fs::path& work_tree);
+		static size_t getObjectIdSize(const fs::path& git_directory);
+		static Timestamp toTimestamp(fs::file_time_type time);
+
+		static uint32_t readUint32(const std::vector<char>& index, size_t offset);
+		static uint16_t readUint16(const std::vector<char>& index, size_t offset);
+		static size_t readOffset(const std::vector<char>& index, size_t& offset);
+
+		void parse(const std::vector<char>& index, size_t object_id_size);
+
+	public:
+		GitIndex(const fs::path& work_tree);
+
+		// Shared by everything asking about the same work tree until its index is written again,
+		// nullptr if path isn't in a git work tree or its index can't be read
+		static std::shared_ptr<const GitIndex> forPath(const fs::path& path);
+
+		// The blob id of path if git tracks it and would consider it unmodified, empty otherwise
+		static std::optional<std::string> getCleanBlobId(const fs::path& path);
+
+		// Whether path's current contents are the blob with blob_id, for tracked files git no longer considers
+		// unmodified, e.g. after being touched, false if path isn't in a git work tree
+		static bool hasBlobContents(const fs::path& path, const std::string& blob_id);
+
+		std::optional<std::string> getBlobId(const fs::path& path) const;
+	};
+}
@@ -0,0 +1,128 @@
+#include "git_object_id.h"
+
+namespace callisto {
+	std::vector<unsigned char> GitObjectId::pad(std::string_view header, std::span<const char> contents) {
+		std::vector<unsigned char> padded(header.begin(), header.end());
+		padded.insert(padded.end(), contents.begin(), contents.end());
+
+		const uint64_t bit_length{ static_cast<uint64_t>(padded.size()) * 8 };
+		padded.push_back(0x80);
+		while (padded.size() % BLOCK_SIZE != BLOCK_SIZE - 8) {
+			padded.push_back(0);
+		}
+		for (int shift{ 56 }; shift >= 0; shift -= 8) {
+			padded.push_back(static_cast<unsigned char>(bit_length >> shift));
+		}
+		return padded;
+	}
+
+	std::array<uint32_t, 5> GitObjectId::sha1(const std::vector<unsigned char>& padded) {
+		std::array<uint32_t, 5> state{ 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+
+		for (size_t block{ 0 }; block != padded.size(); block += BLOCK_SIZE) {
+			std::array<uint32_t, 80> w{};
+			for (size_t i{ 0 }; i != 16; ++i) {
+				const auto word{ &padded[block + i * 4] };
+				w[i] = (uint32_t{ word[0] } << 24) | (uint32_t{ word[1] } << 16) | (uint32_t{ word[2] } << 8) | word[3];
+			}
+			for (size_t i{ 16 }; i != 80; ++i) {
+				w[i] = std::rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+			}
+
+			auto [a, b, c, d, e] = state;
+			for (size_t i{ 0 }; i != 80; ++i) {
+				uint32_t f, k;
+				if (i < 20) {
+					f = (b & c) | (~b & d);
+					k = 0x5A827999;
+				}
+				else if (i < 40) {
+					f = b ^ c ^ d;
+					k = 0x6ED9EBA1;
+				}
+				else if (i < 60) {
+					f = (b & c) | (b & d) | (c & d);
+					k = 0x8F1BBCDC;
+				}
+				else {
+					f = b ^ c ^ d;
+					k = 0xCA62C1D6;
+				}
+				const auto temp{ std::rotl(a, 5) + f + e + k + w[i] };
+				e = d;
+				d = c;
+				c = std::rotl(b, 30);
+				b = a;
+				a = temp;
+			}
+
+			state[0] += a;
+			state[1] += b;
+			state[2] += c;
+			state[3] += d;
+			state[4] += e;
+		}
+		return state;
+	}
+
+	std::array<uint32_t, 8> GitObjectId::sha256(const std::vector<unsigned char>& padded) {
+		static constexpr std::array<uint32_t, 64> K{
+			0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+			0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+			0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+			0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+			0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+			0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+			0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+			0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+		};
+		std::array<uint32_t, 8> state{ 0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19 };
+
+		for (size_t block{ 0 }; block != padded.size(); block += BLOCK_SIZE) {
+			std::array<uint32_t, 64> w{};
+			for (size_t i{ 0 }; i != 16; ++i) {
+				const auto word{ &padded[block + i * 4] };
+				w[i] = (uint32_t{ word[0] } << 24) | (uint32_t{ word[1] } << 16) | (uint32_t{ word[2] } << 8) | word[3];
+			}
+			for (size_t i{ 16 }; i != 64; ++i) {
+				const auto s0{ std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3) };
+				const auto s1{ std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10) };
+				w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+			}
+
+			auto [a, b, c, d, e, f, g, h] = state;
+			for (size_t i{ 0 }; i != 64; ++i) {
+				const auto s1{ std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25) };
+				const auto choice{ (e & f) ^ (~e & g) };
+				const auto temp1{ h + s1 + choice + K[i] + w[i] };
+				const auto s0{ std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22) };
+				const auto majority{ (a & b) ^ (a & c) ^ (b & c) };
+				const auto temp2{ s0 + majority };
+				h = g;
+				g = f;
+				f = e;
+				e = d + temp1;
+				d = c;
+				c = b;
+				b = a;
+				a = temp1 + temp2;
+			}
+
+			state[0] += a;
+			state[1] += b;
+			state[2] += c;
+			state[3] += d;
+			state[4] += e;
+			state[5] += f;
+			state[6] += g;
+			state[7] += h;
+		}
+		return state;
+	}
+
+	std::string GitObjectId::ofBlob(std::span<const char> contents, size_t object_id_size) {
+		const auto header{ fmt::format("blob {}", contents.size()) };
+		const auto padded{ pad({ header.c_str(), header.size() + 1 }, contents) };
+		return object_id_size == SHA256_SIZE ? toHex(sha256(padded)) : toHex(sha1(padded));
+	}
+}
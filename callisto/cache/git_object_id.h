@@ -0,0 +1,44 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <bit>
+
+#include <fmt/format.h>
+
+namespace callisto {
+	// Object ids as git computes them, SHA-1 or SHA-256 (depending on the repository's object format)
+	// over a "<type> <size>\0" header followed by the object's contents
+	class GitObjectId {
+	protected:
+		static constexpr size_t BLOCK_SIZE{ 64 };
+
+		// Appends the padding and the message length in bits as both hashes expect it
+		static std::vector<unsigned char> pad(std::string_view header, std::span<const char> contents);
+
+		static std::array<uint32_t, 5> sha1(const std::vector<unsigned char>& padded);
+		static std::array<uint32_t, 8> sha256(const std::vector<unsigned char>& padded);
+
+		template<size_t N>
+		static std::string toHex(const std::array<uint32_t, N>& words) {
+			std::string hex{};
+			hex.reserve(N * 8);
+			for (const auto word : words) {
+				hex += fmt::format("{:08x}", word);
+			}
+			return hex;
+		}
+
+	public:
+		static constexpr size_t SHA1_SIZE{ 20 };
+		static constexpr size_t SHA256_SIZE{ 32 };
+
+		// object_id_size picks the hash, SHA1_SIZE or SHA256_SIZE, the id is returned in lowercase hex like git prints it
+		static std::string ofBlob(std::span<const char> contents, size_t object_id_size);
+	};
+}
@@ -0,0 +1,160 @@
+#include "hasher.h"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace callisto {
+	namespace {
+		// little endian regardless of platform, compilers turn this into a plain load
+		template<typename T>
+		T readLittleEndian(const unsigned char* data) {
+			T value{ 0 };
+			for (size_t i{ 0 }; i != sizeof(T); ++i) {
+				value |= static_cast<T>(data[i]) << (8 * i);
+			}
+			return value;
+		}
+
+		uint64_t readLane(const unsigned char* data) {
+			return readLittleEndian<uint64_t>(data);
+		}
+
+		uint32_t readHalfLane(const unsigned char* data) {
+			return readLittleEndian<uint32_t>(data);
+		}
+	}
+
+	Hasher::Hasher(uint64_t seed) : seed(seed) {
+		accumulators = { seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed, seed - PRIME_1 };
+	}
+
+	uint64_t Hasher::round(uint64_t accumulator, uint64_t lane) {
+		accumulator += lane * PRIME_2;
+		accumulator = std::rotl(accumulator, 31);
+		return accumulator * PRIME_1;
+	}
+
+	uint64_t Hasher::mergeRound(uint64_t hash, uint64_t accumulator) {
+		hash ^= round(0, accumulator);
+		return hash * PRIME_1 + PRIME_4;
+	}
+
+	void Hasher::consumeStripe(const unsigned char* stripe) {
+		for (size_t i{ 0 }; i != accumulators.size(); ++i) {
+			accumulators[i] = round(accumulators[i], readLane(stripe + i * sizeof(uint64_t)));
+		}
+	}
+
+	Hasher& Hasher::update(const void* data, size_t size) {
+		auto bytes{ static_cast<const unsigned char*>(data) };
+		total_size += size;
+
+		if (pending_size + size < STRIPE_SIZE) {
+			std::memcpy(pending.data() + pending_size, bytes, size);
+			pending_size += size;
+			return *this;
+		}
+
+		if (pending_size != 0) {
+			const auto missing{ STRIPE_SIZE - pending_size };
+			std::memcpy(pending.data() + pending_size, bytes, missing);
+			consumeStripe(pending.data());
+			bytes += missing;
+			size -= missing;
+			pending_size = 0;
+		}
+
+		while (size >= STRIPE_SIZE) {
+			consumeStripe(bytes);
+			bytes += STRIPE_SIZE;
+			size -= STRIPE_SIZE;
+		}
+
+		std::memcpy(pending.data(), bytes, size);
+		pending_size = size;
+		return *this;
+	}
+
+	Hasher& Hasher::update(std::span<const char> bytes) {
+		return update(bytes.data(), bytes.size());
+	}
+
+	Hasher& Hasher::update(std::string_view string) {
+		return update(string.data(), string.size());
+	}
+
+	Hasher& Hasher::updateString(std::string_view string) {
+		updateValue(string.size());
+		return update(string);
+	}
+
+	Hasher::Hash Hasher::digest() const {
+		uint64_t hash;
+		if (total_size >= STRIPE_SIZE) {
+			hash = std::rotl(accumulators[0], 1) + std::rotl(accumulators[1], 7)
+				+ std::rotl(accumulators[2], 12) + std::rotl(accumulators[3], 18);
+			for (const auto accumulator : accumulators) {
+				hash = mergeRound(hash, accumulator);
+			}
+		}
+		else {
+			hash = seed + PRIME_5;
+		}
+
+		hash += total_size;
+
+		const auto* remaining{ pending.data() };
+		auto remaining_size{ pending_size };
+		while (remaining_size >= 8) {
+			hash ^= round(0, readLane(remaining));
+			hash = std::rotl(hash, 27) * PRIME_1 + PRIME_4;
+			remaining += 8;
+			remaining_size -= 8;
+		}
+
+		if (remaining_size >= 4) {
+			hash ^= static_cast<uint64_t>(readHalfLane(remaining)) * PRIME_1;
+			hash = std::rotl(hash, 23) * PRIME_2 + PRIME_3;
+			remaining += 4;
+			remaining_size -= 4;
+		}
+
+		while (remaining_size != 0) {
+			hash ^= *remaining * PRIME_5;
+			hash = std::rotl(hash, 11) * PRIME_1;
+			++remaining;
+			--remaining_size;
+		}
+
+		hash ^= hash >> 33;
+		hash *= PRIME_2;
+		hash ^= hash >> 29;
+		hash *= PRIME_3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+
+	Hasher::Hash Hasher::hash(std::span<const char> bytes) {
+		return Hasher().update(bytes).digest();
+	}
+
+	Hasher::Hash Hasher::hashFile(const fs::path& file_path) {
+		std::ifstream file{ file_path, std::ios::in | std::ios::binary };
+		if (!file) {
+			throw CallistoException(fmt::format("Failed to open {} for hashing", file_path.string()));
+		}
+
+		Hasher hasher{};
+		std::vector<char> chunk(1 << 16);
+		while (file.read(chunk.data(), chunk.size()) || file.gcount() != 0) {
+			hasher.update(chunk.data(), static_cast<size_t>(file.gcount()));
+		}
+		return hasher.digest();
+	}
+
+	std::string Hasher::toHex(Hash hash) {
+		return fmt::format("{:016x}", hash);
+	}
+}
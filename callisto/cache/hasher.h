@@ -0,0 +1,68 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <span>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+#include <fmt/format.h>
+
+#include "../callisto_exception.h"
+
+namespace fs = std::filesystem;
+
+namespace callisto {
+	// Streaming XXH64, the cache keys and object names are derived from this, so it must never
+	// change between versions (or the cache format version has to be bumped alongside it)
+	class Hasher {
+	public:
+		using Hash = uint64_t;
+
+	protected:
+		static constexpr uint64_t PRIME_1{ 0x9E3779B185EBCA87ULL };
+		static constexpr uint64_t PRIME_2{ 0xC2B2AE3D27D4EB4FULL };
+		static constexpr uint64_t PRIME_3{ 0x165667B19E3779F9ULL };
+		static constexpr uint64_t PRIME_4{ 0x85EBCA77C2B2AE63ULL };
+		static constexpr uint64_t PRIME_5{ 0x27D4EB2F165667C5ULL };
+
+		static constexpr size_t STRIPE_SIZE{ 32 };
+
+		std::array<uint64_t, 4> accumulators{};
+		std::array<unsigned char, STRIPE_SIZE> pending{};
+		size_t pending_size{ 0 };
+		uint64_t total_size{ 0 };
+		const uint64_t seed;
+
+		static uint64_t round(uint64_t accumulator, uint64_t lane);
+		static uint64_t mergeRound(uint64_t hash, uint64_t accumulator);
+		void consumeStripe(const unsigned char* stripe);
+
+	public:
+		Hasher(uint64_t seed = 0);
+
+		Hasher& update(const void* data, size_t size);
+		Hasher& update(std::span<const char> bytes);
+		Hasher& update(std::string_view string);
+
+		// Prefixed with its length so consecutive strings can't run into each other
+		Hasher& updateString(std::string_view string);
+
+		template<typename T>
+		requires std::is_integral_v<T>
+		Hasher& updateValue(T value) {
+			const auto widened{ static_cast<uint64_t>(value) };
+			return update(&widened, sizeof(widened));
+		}
+
+		Hash digest() const;
+
+		static Hash hash(std::span<const char> bytes);
+		static Hash hashFile(const fs::path& file_path);
+
+		static std::string toHex(Hash hash);
+	};
+}
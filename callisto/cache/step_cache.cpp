@@ -0,0 +1,257 @@
+#include "step_cache.h"
+
+namespace callisto {
+	StepCache::StepCache(const fs::path& store_root, const fs::path& project_root, uintmax_t max_size,
+		const std::optional<fs::path>& shared_store_root) 
+		: store(store_root, shared_store_root), project_root(project_root), max_size(max_size) {}
+
+	std::vector<fs::path> StepCache::expand(const std::vector<fs::path>& paths) {
+		std::vector<fs::path> expanded{};
+		for (const auto& path : paths) {
+			expanded.push_back(path);
+			if (fs::is_directory(path)) {
+				for (const auto& entry : fs::recursive_directory_iterator(path)) {
+					expanded.push_back(entry.path());
+				}
+			}
+		}
+
+		std::sort(expanded.begin(), expanded.end());
+		expanded.erase(std::unique(expanded.begin(), expanded.end()), expanded.end());
+		return expanded;
+	}
+
+	Hasher::Hash StepCache::identify(const Inputs& inputs) const {
+		Hasher hasher{};
+		hasher.updateValue(FORMAT_VERSION);
+
+		// settings often hold paths, e.g. a tool's working directory
+		auto settings{ inputs.settings };
+		std::sort(settings.begin(), settings.end());
+		hasher.updateValue(settings.size());
+		for (const auto& setting : settings) {
+			hasher.updateString(PathUtil::toPortableText(setting, project_root));
+		}
+
+		auto files{ inputs.files };
+		std::sort(files.begin(), files.end());
+		hasher.updateValue(files.size());
+		for (const auto& file : files) {
+			hasher.updateString(PathUtil::toPortable(file, project_root));
+		}
+
+		hasher.updateString(inputs.dependency_report.has_value() ? 
+			PathUtil::toPortable(inputs.dependency_report.value(), project_root) : "");
+		hasher.updateString(inputs.side_files_of.has_value() ?
+			PathUtil::toPortable(inputs.side_files_of.value(), project_root) : "");
+		return hasher.digest();
+	}
+
+	std::optional<Hasher::Hash> StepCache::resultKey(Hasher::Hash identity, const Inputs& inputs,
+		const std::vector<fs::path>& reported_files) const {
+		auto files{ inputs.files };
+		files.insert(files.end(), reported_files.begin(), reported_files.end());
+
+		Hasher hasher{};
+		hasher.updateValue(identity);
+
+		const auto expanded{ expand(files) };
+		hasher.updateValue(expanded.size());
+		for (const auto& file : expanded) {
+			if (!fs::exists(file)) {
+				return {};
+			}
+			hasher.updateString(PathUtil::toPortable(file, project_root));
+			if (fs::is_regular_file(file)) {
+				hasher.updateValue(Hasher::hashFile(file));
+			}
+		}
+
+		hasher.updateValue(rom_before_hash);
+		return hasher.digest();
+	}
+
+	std::optional<StepCache::Result> StepCache::lookup(const Inputs& inputs, std::span<const char> rom) {
+		pending_inputs = inputs;
+		rom_before_hash = Hasher::hash(rom);
+		auto result{ find(inputs, rom.size()) };
+		if (!result.has_value()) {
+			// only needed to diff against once the step has run
+			rom_before.assign(rom.begin(), rom.end());
+		}
+		return result;
+	}
+
+	std::optional<StepCache::Result> StepCache::find(const Inputs& inputs, size_t rom_size) const {
+		const auto identity{ identify(inputs) };
+		std::vector<fs::path> reported_files{};
+		if (inputs.dependency_report.has_value()) {
+			const auto manifest{ store.get(MANIFEST_KIND, identity) };
+			if (!manifest.has_value()) {
+				return {};
+			}
+
+			std::istringstream manifest_stream{ manifest.value() };
+			std::string line;
+			while (std::getline(manifest_stream, line)) {
+				reported_files.push_back(PathUtil::fromPortable(line, project_root));
+			}
+		}
+
+		const auto key{ resultKey(identity, inputs, reported_files) };
+		if (!key.has_value()) {
+			return {};
+		}
+
+		const auto serialized{ store.get(RESULT_KIND, key.value()) };
+		if (!serialized.has_value()) {
+			return {};
+		}
+
+		try {
+			auto result{ deserialize(serialized.value()) };
+			if (result.delta.getSizeBefore() != rom_size) {
+				return {};
+			}
+			spdlog::debug("Found cached step result {}", Hasher::toHex(key.value()));
+			return result;
+		}
+		catch (const CallistoException& e) {
+			spdlog::debug("Ignoring unreadable cached step result {}: {}", Hasher::toHex(key.value()), e.what());
+			return {};
+		}
+	}
+
+	void StepCache::record(std::span<const char> rom_after) {
+		if (!pending_inputs.has_value()) {
+			return;
+		}
+		const auto inputs{ std::move(pending_inputs.value()) };
+		pending_inputs.reset();
+
+		Result result{};
+
+		// keyed on the state of the files after the step, which is what the next lookup will see
+		std::vector<fs::path> reported_files{};
+		if (inputs.dependency_report.has_value()) {
+			const auto& report_path{ inputs.dependency_report.value() };
+			std::ifstream report_file{ report_path };
+			if (!report_file) {
+				// can't tell what the step read, so it can't be cached
+				return;
+			}
+			std::string line;
+			while (std::getline(report_file, line)) {
+				fs::path path{ line };
+				if (!path.is_absolute()) {
+					path = report_path.parent_path() / path;
+				}
+				reported_files.push_back(fs::absolute(fs::weakly_canonical(path)));
+				result.dependency_report.push_back(PathUtil::toPortable(reported_files.back(), project_root));
+			}
+		}
+
+		auto outputs{ expand(inputs.outputs) };
+		if (inputs.side_files_of.has_value()) {
+			const auto side_files{ PathUtil::getTemporaryRomSideFiles(inputs.side_files_of.value()) };
+			outputs.insert(outputs.end(), side_files.begin(), side_files.end());
+		}
+
+		for (const auto& output : outputs) {
+			if (!fs::is_regular_file(output)) {
+				continue;
+			}
+			std::ifstream output_file{ output, std::ios::in | std::ios::binary };
+			result.output_files.push_back({ PathUtil::toPortable(output, project_root),
+				std::string(std::istreambuf_iterator<char>(output_file), std::istreambuf_iterator<char>()) });
+		}
+
+		const auto identity{ identify(inputs) };
+		const auto key{ resultKey(identity, inputs, reported_files) };
+		if (!key.has_value()) {
+			return;
+		}
+
+		result.delta = RomDelta::between(rom_before, rom_after);
+
+		// result first, so a manifest never points at something that isn't there
+		store.put(RESULT_KIND, key.value(), serialize(result));
+		if (inputs.dependency_report.has_value()) {
+			std::ostringstream manifest{};
+			for (const auto& file : reported_files) {
+				manifest << PathUtil::toPortable(file, project_root) << '\n';
+			}
+			store.put(MANIFEST_KIND, identity, manifest.str());
+		}
+		spdlog::debug("Cached step result {}", Hasher::toHex(key.value()));
+	}
+
+	void StepCache::evict() const {
+		store.evict(max_size);
+	}
+
+	void StepCache::restoreOutputs(const Inputs& inputs, const Result& result) const {
+		for (const auto& [portable_path, contents] : result.output_files) {
+			const auto path{ PathUtil::fromPortable(portable_path, project_root) };
+			if (path.has_parent_path()) {
+				fs::create_directories(path.parent_path());
+			}
+			std::ofstream output_file{ path, std::ios::out | std::ios::binary };
+			output_file.write(contents.data(), contents.size());
+			if (!output_file) {
+				throw CallistoException(fmt::format("Failed to restore cached output file {}", path.string()));
+			}
+		}
+
+		if (inputs.dependency_report.has_value()) {
+			std::ofstream report_file{ inputs.dependency_report.value() };
+			for (const auto& line : result.dependency_report) {
+				report_file << PathUtil::fromPortable(line, project_root).string() << '\n';
+			}
+		}
+	}
+
+	std::string StepCache::serialize(const Result& result) {
+		std::ostringstream out{};
+		BinaryWriter writer{ out };
+		writer.write<uint32_t>(FORMAT_VERSION);
+		result.delta.serialize(out);
+
+		writer.write<uint32_t>(static_cast<uint32_t>(result.output_files.size()));
+		for (const auto& [path, contents] : result.output_files) {
+			writer.writeString(path);
+			writer.writeString(contents);
+		}
+
+		writer.write<uint32_t>(static_cast<uint32_t>(result.dependency_report.size()));
+		for (const auto& line : result.dependency_report) {
+			writer.writeString(line);
+		}
+
+		return out.str();
+	}
+
+	StepCache::Result StepCache::deserialize(const std::string& serialized) {
+		std::istringstream in{ serialized };
+		BinaryReader reader{ in, "Cached step result" };
+		if (reader.read<uint32_t>() != FORMAT_VERSION) {
+			throw CallistoException("Cached step result format has changed");
+		}
+
+		Result result{};
+		result.delta = RomDelta::deserialize(in);
+
+		const auto file_count{ reader.read<uint32_t>() };
+		for (uint32_t i{ 0 }; i != file_count; ++i) {
+			auto path{ reader.readString() };
+			result.output_files.push_back({ std::move(path), reader.readString() });
+		}
+
+		const auto line_count{ reader.read<uint32_t>() };
+		for (uint32_t i{ 0 }; i != line_count; ++i) {
+			result.dependency_report.push_back(reader.readString());
+		}
+
+		return result;
+	}
+}
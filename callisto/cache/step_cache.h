@@ -0,0 +1,99 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <optional>
+#include <span>
+#include <utility>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "hasher.h"
+#include "content_store.h"
+#include "../rom/rom_delta.h"
+#include "../path_util.h"
+#include "../binary_io.h"
+
+namespace fs = std::filesystem;
+
+namespace callisto {
+	// Remembers what an external program did to the ROM and which files it wrote, so the program doesn't
+	// have to be launched again as long as neither its inputs nor the ROM going into the step have changed
+	//
+	// Steps that report the files they read afterwards are found in two steps like in AsarCache, a manifest
+	// keyed on the step lists the files from the last report, the result is keyed on the contents of those
+	// and all other inputs
+	//
+	// Paths are keyed and stored relative to the project root, so results can be shared between clones of a project
+	class StepCache {
+	public:
+		static constexpr uint32_t FORMAT_VERSION{ 4 };
+
+		// Everything a step's effect depends on besides the ROM it's applied to
+		struct Inputs {
+			// Names the step and any settings that change what it does
+			std::vector<std::string> settings;
+			// Files the step reads, directories stand for everything below them
+			std::vector<fs::path> files;
+			// Where the step lists further files it read, if it does, relative entries are relative to it
+			std::optional<fs::path> dependency_report;
+			// Files the step writes besides the ROM, directories stand for everything below them
+			std::vector<fs::path> outputs;
+			// The ROM the step is run on, if the files it writes next to it are outputs too, see PathUtil::getTemporaryRomSideFiles
+			std::optional<fs::path> side_files_of;
+		};
+
+		struct Result {
+			RomDelta delta;
+			// Portable path and contents of each output file, see PathUtil::toPortable
+			std::vector<std::pair<std::string, std::string>> output_files;
+			// Portable paths of the files the step reported
+			std::vector<std::string> dependency_report;
+		};
+
+	protected:
+		static constexpr auto MANIFEST_KIND{ "step_manifests" };
+		static constexpr auto RESULT_KIND{ "step_results" };
+
+		const ContentStore store;
+		const fs::path project_root;
+		// of the whole store, which is shared with AsarCache
+		const uintmax_t max_size;
+
+		// the last lookup, kept around to diff against and key the result on once it missed, the ROM is only copied on a miss
+		std::optional<Inputs> pending_inputs{};
+		std::vector<char> rom_before{};
+		Hasher::Hash rom_before_hash{};
+
+		Hasher::Hash identify(const Inputs& inputs) const;
+		std::optional<Result> find(const Inputs& inputs, size_t rom_size) const;
+		std::optional<Hasher::Hash> resultKey(Hasher::Hash identity, const Inputs& inputs,
+			const std::vector<fs::path>& reported_files) const;
+
+		static std::vector<fs::path> expand(const std::vector<fs::path>& paths);
+
+		static std::string serialize(const Result& result);
+		static Result deserialize(const std::string& serialized);
+
+	public:
+		StepCache(const fs::path& store_root, const fs::path& project_root, uintmax_t max_size,
+			const std::optional<fs::path>& shared_store_root = {});
+
+		// On a hit, the result can be replayed in place of running the step
+		std::optional<Result> lookup(const Inputs& inputs, std::span<const char> rom);
+
+		// Stores what the last successful run of the step did, must follow a missed lookup for it
+		void record(std::span<const char> rom_after);
+
+		// Writes the output files and dependency report back to where the step put them
+		void restoreOutputs(const Inputs& inputs, const Result& result) const;
+
+		// Removes least recently used results, AsarCache's included, until the store fits its maximum size again,
+		// walks the whole store, so this is done once per build rather than after every step
+		void evict() const;
+	};
+}
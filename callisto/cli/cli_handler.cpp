@@ -51,6 +51,8 @@ namespace callisto {
 		auto edit_sub{ app.add_subcommand("edit", "Opens project ROM in Lunar Magic")->fallthrough() };
 		auto package_sub{ app.add_subcommand("package", "Packages project ROM into a BPS patch")->fallthrough() };
 		auto profiles_sub{ app.add_subcommand("profiles", "Lists available configuration profiles")->fallthrough() };
+		auto blame_sub{ app.add_subcommand("blame", "Shows what last wrote to a ROM address or range during the last build")->fallthrough() };
+		auto freespace_sub{ app.add_subcommand("freespace", "Shows free space and RATS protected blocks per bank as of the last build")->fallthrough() };
 
 		bool abort_on_unsaved{ false };
 		build_sub->add_flag(
@@ -59,6 +61,13 @@ namespace callisto {
 			"Will cause the build to abort if there are unsaved resources in the ROM, default is to export them and then build"
 		);
 
+		bool resume{ false };
+		build_sub->add_flag(
+			"--resume",
+			resume,
+			"Continues the last rebuild from the first step that failed or whose inputs changed since, instead of starting over"
+		);
+
 		update_sub->add_flag(
 			"--no-export",
 			abort_on_unsaved,
@@ -108,7 +117,7 @@ namespace callisto {
 			}
 
 			Rebuilder rebuilder{};
-			rebuilder.build(*config);
+			rebuilder.build(*config, resume);
 #ifdef _WIN32
 			if (config->lunar_magic_path.isSet() && config->enable_automatic_reloads.getOrDefault(true)) {
 				lunar_magic_wrapper.reloadRom(config->output_rom.getOrThrow());
@@ -236,6 +245,151 @@ namespace callisto {
 			exit(0);
 		});
 
+		std::vector<std::string> blame_addresses{};
+		blame_sub->add_option(
+			"addresses",
+			blame_addresses,
+			"Hex address to look up, or first and last address of a range"
+		)->required()->expected(1, 2);
+
+		bool blame_pc{ false };
+		blame_sub->add_flag(
+			"--pc",
+			blame_pc,
+			"Treat addresses as headered PC offsets, the way the conflict log prints them, instead of SNES addresses"
+		);
+
+		blame_sub->add_option(
+			"-p,--profile",
+			profile_name,
+			"The profile to look up addresses for"
+		);
+
+		blame_sub->callback([&] {
+			init();
+			const auto config{ config_manager.getConfiguration(profile_name) };
+			const auto index{ Builder::readOwnershipIndex(config->project_root.getOrThrow()) };
+
+			auto rom_mapper{ RomView::Mapper::LOROM };
+			if (config->output_rom.isSet() && fs::exists(config->output_rom.getOrThrow())) {
+				const MappedRom output_rom{ config->output_rom.getOrThrow() };
+				rom_mapper = RomView::detectMapper(output_rom.getBody());
+			}
+
+			const auto to_pc{ [&](const std::string& input) {
+				auto digits{ input };
+				if (digits.starts_with('$')) {
+					digits.erase(0, 1);
+				}
+				else if (digits.starts_with("0x") || digits.starts_with("0X")) {
+					digits.erase(0, 2);
+				}
+
+				size_t parsed{ 0 };
+				int address{};
+				try {
+					address = std::stoi(digits, &parsed, 16);
+				}
+				catch (const std::exception&) {}
+				if (digits.empty() || parsed != digits.size()) {
+					throw std::runtime_error(fmt::format("'{}' is not a valid hex address", input));
+				}
+
+				if (blame_pc) {
+					if (address < ConflictWriter::HEADER_SIZE) {
+						throw std::runtime_error(fmt::format("PC offset 0x{:06X} lies within the header", address));
+					}
+					return address - ConflictWriter::HEADER_SIZE;
+				}
+
+				const auto pc{ RomView::snesToPc(address, rom_mapper) };
+				if (!pc.has_value()) {
+					throw std::runtime_error(fmt::format("SNES address ${:06X} does not map to ROM", address));
+				}
+				return pc.value();
+			} };
+
+			const auto start{ to_pc(blame_addresses.front()) };
+			const auto end{ to_pc(blame_addresses.back()) + 1 };
+			if (end <= start) {
+				throw std::runtime_error("Last address of range lies before its first one");
+			}
+
+			// PC offsets are shown headered, same as in the conflict log
+			const auto describe{ [&](int pc_start, int pc_end) {
+				const auto to_snes{ [&](int pc) {
+					const auto snes{ RomView::pcToSnes(pc, rom_mapper) };
+					return snes.has_value() ? fmt::format("${:06X}", snes.value()) : std::string("unmapped");
+				} };
+				if (pc_end - pc_start == 1) {
+					return fmt::format("{} (PC: 0x{:06X} headered)", to_snes(pc_start), pc_start + ConflictWriter::HEADER_SIZE);
+				}
+				return fmt::format("{}-{} (PC: 0x{:06X}-0x{:06X} headered)",
+					to_snes(pc_start), to_snes(pc_end - 1), pc_start + ConflictWriter::HEADER_SIZE, pc_end - 1 + ConflictWriter::HEADER_SIZE);
+			} };
+
+			// the index only knows about what settings.check_conflicts covered during the last build
+			int cursor{ start };
+			for (const auto& interval : index.query(start, end)) {
+				if (static_cast<int>(interval.start) > cursor) {
+					fmt::print("{}: no tracked writes\n", describe(cursor, interval.start));
+				}
+				fmt::print("{}: {}\n", describe(interval.start, interval.end), index.getWriterName(interval.writer));
+				cursor = interval.end;
+			}
+			if (cursor < end) {
+				fmt::print("{}: no tracked writes\n", describe(cursor, end));
+			}
+
+			exit(0);
+		});
+
+		bool list_blocks{ false };
+		freespace_sub->add_flag(
+			"--blocks",
+			list_blocks,
+			"Also list every RATS protected block along with its owner"
+		);
+
+		freespace_sub->add_option(
+			"-p,--profile",
+			profile_name,
+			"The profile to show free space for"
+		);
+
+		freespace_sub->callback([&] {
+			init();
+			const auto config{ config_manager.getConfiguration(profile_name) };
+			const auto index{ Builder::readFreespaceIndex(config->project_root.getOrThrow()) };
+
+			const auto to_snes{ [&](size_t pc) {
+				const auto snes{ RomView::pcToSnes(static_cast<int>(pc), index.getMapper()) };
+				return snes.has_value() ? fmt::format("${:06X}", snes.value()) : std::string("unmapped");
+			} };
+
+			if (list_blocks) {
+				for (const auto& block : index.getBlocks()) {
+					fmt::print("{}-{} (PC: 0x{:06X} headered, 0x{:X} bytes): {}\n",
+						to_snes(block.start), to_snes(block.start + block.size - 1), block.start + ConflictWriter::HEADER_SIZE,
+						block.size, block.owner.value_or("unknown"));
+				}
+				fmt::print("\n");
+			}
+
+			// banks without a SNES address still count towards the totals below
+			fmt::print("Bank      Protected  Free     Runs  Largest  Fragmentation\n");
+			for (const auto& bank : index.getBanks()) {
+				const auto bank_name{ bank.bank == -1 ? std::string("unmapped") : fmt::format("${:02X}", bank.bank) };
+				fmt::print("{:<8}  0x{:05X}    0x{:05X}  {:>4}  0x{:05X}  {:>12.1f}%\n", bank_name, bank.protected_bytes,
+					bank.free_bytes, bank.free_runs, bank.largest_free_run, bank.fragmentation() * 100);
+			}
+
+			fmt::print("\n0x{:X} bytes free in total, largest free run is 0x{:X} bytes, {:.1f}% fragmented\n",
+				index.getFreeBytes(), index.getLargestFreeRun(), index.getFragmentation() * 100);
+
+			exit(0);
+		});
+
 		profiles_sub->callback([&] {
 			fmt::print("{}", fmt::join(config_manager.getProfileNames(), "\n"));
 			exit(0);
@@ -11,6 +11,7 @@
 #include "../builders/quick_builder.h"
 #include "../saver/saver.h"
 #include "../saver/marker.h"
+#include "../conflicts/conflict_writer.h"
 
 #include "../globals.h"
 
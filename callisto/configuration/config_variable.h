@@ -205,7 +205,7 @@ namespace callisto {
 		}
 
 		void forceSet(const V& value, ConfigurationLevel level) {
-			values.insert({ level, value });
+			values.insert_or_assign(level, value);
 		}
 
 		bool isSet() const {
@@ -9,6 +9,13 @@ namespace callisto {
 			color_configurations.emplace(config_color_str, ColorConfiguration(config_color_str));
 		}
 
+		for (const auto& [_, paths] : config_file_map) {
+			source_files.insert(source_files.end(), paths.begin(), paths.end());
+		}
+		for (const auto& [_, path] : variable_file_map) {
+			source_files.push_back(path);
+		}
+
 		const auto user_variables{ parseVariableFiles(variable_file_map) };
 		const auto config_files{ parseConfigFiles(config_file_map) };
 
@@ -19,10 +26,28 @@ namespace callisto {
 		discoverEmulators(config_files, user_variables);
 
 		fillInConfiguration(config_files, user_variables);
+		moveTemporaryFolderToMemory();
 
 		finalizeBuildOrder();
 	}
 
+	void Configuration::moveTemporaryFolderToMemory() {
+		if (!temporary_folder_in_memory.getOrDefault(false) || !project_root.isSet()) {
+			return;
+		}
+
+		const auto in_memory_directory{ PathUtil::getInMemoryDirectoryPath() };
+		if (!in_memory_directory.has_value()) {
+			spdlog::warn(fmt::format(colors::WARNING, "No in-memory file system available, using temporary folder '{}' instead",
+				temporary_folder.getOrDefault({}).string()));
+			return;
+		}
+
+		// one folder per project, so several projects can build at once
+		const auto project_key{ std::hash<std::string>{}(project_root.getOrThrow().string()) };
+		temporary_folder.forceSet(in_memory_directory.value() / fmt::format("{:016X}", project_key), ConfigurationLevel::PROFILE);
+	}
+
 	void Configuration::verifyPatchModuleExclusivity() {
 		if (patches.isSet() && !module_configurations.empty()) {
 			for (const auto& patch : patches.getOrThrow()) {
@@ -417,12 +442,14 @@ namespace callisto {
 
 		trySet(output_rom, config_file, level, root, user_variables);
 		trySet(temporary_folder, config_file, level, root, user_variables);
+		trySet(temporary_folder_in_memory, config_file, level);
 		trySet(bps_package, config_file, level, root, user_variables);
 
 		trySet(level_import_flag, config_file, level, user_variables);
 
 		trySet(check_conflicts, config_file, level, user_variables);
 		trySet(conflict_log_file, config_file, level, root, user_variables);
+		trySet(conflict_log_format, config_file, level, user_variables);
 		ignored_conflict_symbol_strings.trySet(config_file, level, user_variables);
 
 		trySet(flips_path, config_file, level, root, user_variables);
@@ -447,6 +474,16 @@ namespace callisto {
 		trySet(enable_automatic_exports, config_file, level);
 		trySet(enable_automatic_reloads, config_file, level);
 
+		trySet(cache_assembly, config_file, level);
+		trySet(cache_lunar_magic, config_file, level);
+		step_cache_size.trySet(config_file, level);
+		trySet(cache_builds, config_file, level);
+		build_cache_size.trySet(config_file, level);
+		trySet(cache_checkpoints, config_file, level);
+		checkpoint_cache_size.trySet(config_file, level);
+		trySet(cache_journal, config_file, level);
+		trySet(cache_shared_directory, config_file, level, root, user_variables);
+
 		std::optional<toml::array> modules_array;
 		try {
 			auto& resources_table{ toml::find(config_file, "resources") };
@@ -517,6 +554,8 @@ namespace callisto {
 			tool.static_dependencies.trySet(config_file, level, tool.working_directory, user_variables);
 			tool.dependency_report_file.trySet(config_file, level, tool.working_directory, user_variables);
 			trySet(tool.pass_rom, config_file, level);
+			trySet(tool.cache, config_file, level);
+			tool.cached_outputs.trySet(config_file, level, tool.working_directory, user_variables);
 		}
 
 		for (auto& [_, color_config] : color_configurations) {
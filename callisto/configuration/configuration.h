@@ -74,6 +74,7 @@ namespace callisto {
 		void verifyModuleExclusivity();
 		void verifyPatchUniqueness();
 		void finalizeBuildOrder();
+		void moveTemporaryFolderToMemory();
 		void transferConfiguredColors();
 
 		bool trySet(StringConfigVariable& variable, const toml::value& table, 
@@ -104,6 +105,9 @@ namespace callisto {
 
 		const std::optional<std::string> profile_name{};
 
+		// Every config and variable file this configuration was read from
+		std::vector<fs::path> source_files{};
+
 		PathConfigVariable project_root{ {"settings", "project_root"} };
 		StringConfigVariable level_import_flag{ {"settings", "level_import_flag"} };
 		BoolConfigVariable use_text_map16_format{ {"settings", "use_text_map16_format"} };
@@ -111,13 +115,25 @@ namespace callisto {
 		PathConfigVariable clean_rom{ {"settings", "clean_rom"} };
 		StringConfigVariable check_conflicts{ {"settings", "check_conflicts"} };
 		PathConfigVariable conflict_log_file { {"settings", "conflict_log_file"} };
+		StringConfigVariable conflict_log_format{ {"settings", "conflict_log_format"} };
 		StringVectorConfigVariable ignored_conflict_symbol_strings{ {"settings", "ignored_conflict_symbols"} };
 
 		BoolConfigVariable enable_automatic_reloads{ {"settings", "enable_automatic_reloads"} };
 		BoolConfigVariable enable_automatic_exports{ {"settings", "enable_automatic_exports"} };
 
+		BoolConfigVariable cache_assembly{ {"cache", "assembly"} };
+		BoolConfigVariable cache_lunar_magic{ {"cache", "lunar_magic"} };
+		IntegerConfigVariable step_cache_size{ {"cache", "step_cache_size"} };
+		BoolConfigVariable cache_builds{ {"cache", "builds"} };
+		IntegerConfigVariable build_cache_size{ {"cache", "build_cache_size"} };
+		BoolConfigVariable cache_checkpoints{ {"cache", "checkpoints"} };
+		IntegerConfigVariable checkpoint_cache_size{ {"cache", "checkpoint_cache_size"} };
+		BoolConfigVariable cache_journal{ {"cache", "journal"} };
+		PathConfigVariable cache_shared_directory{ {"cache", "shared_directory"} };
+
 		PathConfigVariable output_rom{ {"output", "output_rom"} };
 		PathConfigVariable temporary_folder{ {"output", "temporary_folder"} };
+		BoolConfigVariable temporary_folder_in_memory{ {"output", "temporary_folder_in_memory"} };
 		PathConfigVariable bps_package{ {"output", "bps_package"} };
 
 		PathConfigVariable flips_path{ {"tools", "FLIPS", "executable"} };
@@ -18,6 +18,9 @@ namespace callisto {
 		BoolConfigVariable pass_rom;
 		BoolConfigVariable takes_user_input;
 
+		BoolConfigVariable cache;
+		ExtendablePathVectorConfigVariable cached_outputs;
+
 		ToolConfiguration(const std::string& tool_name) :
 			working_directory(PathConfigVariable({ "tools", "generic", tool_name, "directory" })),
 			executable(PathConfigVariable({ "tools", "generic", tool_name, "executable" })),
@@ -25,7 +28,9 @@ namespace callisto {
 			options(StringConfigVariable({ "tools", "generic", tool_name, "options" })),
 			static_dependencies(StaticResourceDependencyConfigVariable({ "tools", "generic", tool_name, "static_dependencies" })),
 			dependency_report_file(PathConfigVariable({ "tools", "generic", tool_name, "dependency_report_file" })),
-			pass_rom(BoolConfigVariable({"tools", "generic", tool_name, "pass_rom"})) 
+			pass_rom(BoolConfigVariable({"tools", "generic", tool_name, "pass_rom"})),
+			cache(BoolConfigVariable({ "tools", "generic", tool_name, "cache" })),
+			cached_outputs(ExtendablePathVectorConfigVariable({ "tools", "generic", tool_name, "cached_outputs" }))
 		{}
 	};
 }
@@ -0,0 +1,123 @@
+#include "conflict_writer.h"
+
+namespace callisto {
+	ConflictWriter::ConflictWriter(const fs::path& log_file_path, Format format)
+		: log_file_path(log_file_path), format(format) {}
+
+	void ConflictWriter::open() {
+		const auto mode{ format == Format::BINARY ? std::ios::out | std::ios::binary : std::ios::out };
+		log_file.open(log_file_path, mode);
+		if (!log_file) {
+			throw CallistoException(fmt::format("Failed to open conflict log file '{}'", log_file_path.string()));
+		}
+
+		if (format == Format::BINARY) {
+			BinaryWriter binary{ log_file };
+			binary.writeBytes({ BINARY_MAGIC, 4 });
+			binary.writeLittleEndian(BINARY_FORMAT_VERSION);
+		}
+	}
+
+	void ConflictWriter::write(const Conflict& conflict) {
+		if (!log_file.is_open()) {
+			open();
+		}
+
+		if (format == Format::TEXT) {
+			if (conflict_count != 0) {
+				log_file << '\n';
+			}
+			log_file << toText(conflict, false);
+		}
+		else if (format == Format::JSON_LINES) {
+			auto writers(json::array());
+			for (const auto& [writer, bytes] : conflict.written_bytes) {
+				std::string hex{};
+				hex.reserve(bytes.size() * 2);
+				for (const auto byte : bytes) {
+					fmt::format_to(std::back_inserter(hex), "{:02X}", byte);
+				}
+				writers.push_back({ {"name", writer}, {"bytes", hex} });
+			}
+
+			log_file << json({
+				{"pc", conflict.pc_start + HEADER_SIZE},
+				{"snes", conflict.snes_start == -1 ? json(nullptr) : json(conflict.snes_start)},
+				{"size", conflict.size},
+				{"writers", writers}
+			}).dump() << '\n';
+		}
+		else {
+			BinaryWriter binary{ log_file };
+			binary.writeLittleEndian(static_cast<uint32_t>(conflict.pc_start));
+			binary.writeLittleEndian(static_cast<uint32_t>(conflict.snes_start));
+			binary.writeLittleEndian(static_cast<uint32_t>(conflict.size));
+			binary.writeLittleEndian(static_cast<uint32_t>(conflict.written_bytes.size()));
+			for (const auto& [writer, bytes] : conflict.written_bytes) {
+				binary.writeLittleEndian(static_cast<uint32_t>(writer.size()));
+				binary.writeBytes(writer);
+				binary.writeBytes({ reinterpret_cast<const char*>(bytes.data()), bytes.size() });
+			}
+		}
+
+		++conflict_count;
+	}
+
+	void ConflictWriter::finish() {
+		if (log_file.is_open()) {
+			log_file.close();
+		}
+		else if (fs::exists(log_file_path)) {
+			fs::remove(log_file_path);
+		}
+	}
+
+	ConflictWriter::Format ConflictWriter::parseFormat(const std::string& format_string) {
+		if (format_string == "text") {
+			return Format::TEXT;
+		}
+		else if (format_string == "jsonl") {
+			return Format::JSON_LINES;
+		}
+		else if (format_string == "binary") {
+			return Format::BINARY;
+		}
+		else {
+			throw CallistoException(fmt::format(
+				"Unknown settings.conflict_log_format setting '{}'",
+				format_string
+			));
+		}
+	}
+
+	std::string ConflictWriter::toText(const Conflict& conflict, bool for_console) {
+		std::ostringstream output{};
+		const auto byte_or_bytes{ conflict.size == 1 ? "byte" : "bytes" };
+		const auto line_end{ for_console ? "\n\r" : "\n" };
+		const auto snes{ conflict.snes_start == -1 ? std::string("unmapped") : fmt::format("${:06X}", conflict.snes_start) };
+		output << fmt::format(
+			"Conflict - 0x{:X} {} at SNES: {} (unheadered), PC: 0x{:06X} (headered):{}",
+			conflict.size, byte_or_bytes,
+			snes, conflict.pc_start + HEADER_SIZE,  // idk if the + 0x200 is controversial
+			line_end
+		);
+
+		for (const auto& [writer, written_bytes] : conflict.written_bytes) {
+			output << '\t' << writer << ':';
+			size_t i{ 0 };
+			while (i != written_bytes.size()) {
+				if (for_console && i == 0x100) {
+					output << "...";
+					break;
+				}
+				if (i % 0x10 == 0) {
+					output << line_end << "\t\t";
+				}
+				output << fmt::format("{:02X} ", written_bytes.at(i++));
+			}
+			output << line_end;
+		}
+
+		return output.str();
+	}
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <optional>
+#include <cstdint>
+#include <stdexcept>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include "../callisto_exception.h"
+#include "../binary_io.h"
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace callisto {
+	// Streams conflicts to the conflict log as they are found instead of collecting them first,
+	// the file is only created once the first conflict comes in
+	//
+	// JSON Lines output has one object per conflict with the headered "pc" offset like the text output,
+	// "snes" is null if the offset doesn't map to an address
+	//
+	// Binary layout, integers are little endian:
+	//     "CCNF", u32 format version
+	//     per conflict: u32 unheadered pc offset, u32 snes address or 0xFFFFFFFF if unmapped, u32 size, u32 writer count
+	//         per writer: u32 name length, name, size bytes written by it
+	class ConflictWriter {
+	public:
+		using WrittenBytes = std::vector<std::pair<std::string, std::vector<unsigned char>>>;
+
+		enum class Format {
+			TEXT,
+			JSON_LINES,
+			BINARY
+		};
+
+		static constexpr auto BINARY_MAGIC{ "CCNF" };
+		static constexpr uint32_t BINARY_FORMAT_VERSION{ 1 };
+		// Text output shows PC offsets as if the ROM had a header, anything else that shows PC offsets to the user should too
+		static constexpr int HEADER_SIZE{ 0x200 };
+
+		struct Conflict {
+			int pc_start;
+			// -1 if the offset doesn't map to an address
+			int snes_start;
+			int size;
+			const WrittenBytes& written_bytes;
+		};
+
+	protected:
+		const fs::path log_file_path;
+		const Format format;
+
+		std::ofstream log_file{};
+		size_t conflict_count{ 0 };
+
+		void open();
+
+	public:
+		ConflictWriter(const fs::path& log_file_path, Format format);
+
+		void write(const Conflict& conflict);
+
+		// Removes the log from a previous run if nothing was written to it
+		void finish();
+
+		size_t getConflictCount() const {
+			return conflict_count;
+		}
+
+		static Format parseFormat(const std::string& format_string);
+		static std::string toText(const Conflict& conflict, bool for_console);
+	};
+}
@@ -0,0 +1,95 @@
+#include "ownership_index.h"
+
+namespace callisto {
+	OwnershipIndex::OwnershipIndex(const WriteLedger& write_ledger) {
+		std::unordered_map<WriteLedger::WriterId, uint32_t> writers{};
+
+		for (const auto& segment : write_ledger.getSegments()) {
+			// runs are in build order, so the last one belongs to whoever wrote last
+			const auto ledger_writer{ write_ledger.getRun(segment.runs.back()).writer };
+			if (ledger_writer == WriteLedger::ORIGINAL_BYTES_WRITER) {
+				continue;
+			}
+
+			const auto [entry, inserted] { writers.insert({ ledger_writer, static_cast<uint32_t>(writer_names.size()) }) };
+			if (inserted) {
+				writer_names.push_back(write_ledger.getWriterName(ledger_writer));
+			}
+			const auto writer{ entry->second };
+
+			const auto start{ static_cast<uint32_t>(segment.start) };
+			const auto end{ static_cast<uint32_t>(segment.end) };
+			if (!intervals.empty() && intervals.back().end == start && intervals.back().writer == writer) {
+				intervals.back().end = end;
+			}
+			else {
+				intervals.push_back({ start, end, writer });
+			}
+		}
+	}
+
+	std::vector<OwnershipIndex::Interval> OwnershipIndex::query(size_t start, size_t end) const {
+		std::vector<Interval> owned{};
+
+		// first interval that ends after start
+		auto it{ std::upper_bound(intervals.begin(), intervals.end(), start, [](size_t address, const Interval& interval) {
+			return address < interval.end;
+		}) };
+
+		while (it != intervals.end() && it->start < end) {
+			owned.push_back({
+				std::max(it->start, static_cast<uint32_t>(start)),
+				std::min(it->end, static_cast<uint32_t>(end)),
+				it->writer
+			});
+			++it;
+		}
+
+		return owned;
+	}
+
+	void OwnershipIndex::serialize(std::ostream& out) const {
+		BinaryWriter writer{ out };
+		writer.write<uint32_t>(FORMAT_VERSION);
+
+		writer.write<uint32_t>(static_cast<uint32_t>(writer_names.size()));
+		for (const auto& name : writer_names) {
+			writer.writeString(name);
+		}
+
+		writer.write<uint32_t>(static_cast<uint32_t>(intervals.size()));
+		for (const auto& interval : intervals) {
+			writer.write<uint32_t>(interval.start);
+			writer.write<uint32_t>(interval.end);
+			writer.write<uint32_t>(interval.writer);
+		}
+	}
+
+	OwnershipIndex OwnershipIndex::deserialize(std::istream& in) {
+		BinaryReader reader{ in, "Ownership index" };
+		if (reader.read<uint32_t>() != FORMAT_VERSION) {
+			throw CallistoException("Ownership index format has changed, rebuild to recreate it");
+		}
+
+		OwnershipIndex index{};
+
+		const auto writer_count{ reader.read<uint32_t>() };
+		for (uint32_t i{ 0 }; i != writer_count; ++i) {
+			index.writer_names.push_back(reader.readString());
+		}
+
+		const auto interval_count{ reader.read<uint32_t>() };
+		index.intervals.reserve(interval_count);
+		for (uint32_t i{ 0 }; i != interval_count; ++i) {
+			const auto start{ reader.read<uint32_t>() };
+			const auto end{ reader.read<uint32_t>() };
+			const auto writer{ reader.read<uint32_t>() };
+			if (start >= end || writer >= writer_count || (!index.intervals.empty() && index.intervals.back().end > start)) {
+				throw CallistoException("Ownership index is malformed");
+			}
+			index.intervals.push_back({ start, end, writer });
+		}
+
+		return index;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <stdexcept>
+
+#include "write_ledger.h"
+#include "../callisto_exception.h"
+#include "../binary_io.h"
+
+namespace callisto {
+	// Sorted, non-overlapping address ranges of the ROM together with the writer that last changed them,
+	// derived from a WriteLedger so ownership can be looked up without reassembling anything
+	class OwnershipIndex {
+	public:
+		static constexpr uint32_t FORMAT_VERSION{ 2 };
+
+		struct Interval {
+			uint32_t start;
+			uint32_t end;
+			uint32_t writer;
+		};
+
+	protected:
+		std::vector<std::string> writer_names{};
+		std::vector<Interval> intervals{};
+
+	public:
+		OwnershipIndex() = default;
+		OwnershipIndex(const WriteLedger& write_ledger);
+
+		const std::string& getWriterName(uint32_t writer) const {
+			return writer_names.at(writer);
+		}
+
+		// Returns the owned parts of [start, end), clipped to it
+		std::vector<Interval> query(size_t start, size_t end) const;
+
+		void serialize(std::ostream& out) const;
+		static OwnershipIndex deserialize(std::istream& in);
+	};
+}
@@ -0,0 +1,51 @@
+#include "rom_snapshot_queue.h"
+
+namespace callisto {
+	RomSnapshotQueue::RomSnapshotQueue(size_t capacity) : free_buffers(capacity + 2) {}
+
+	std::vector<char> RomSnapshotQueue::acquireBuffer() {
+		std::unique_lock lock{ mutex };
+		buffer_available.wait(lock, [&] { return !free_buffers.empty(); });
+
+		auto buffer{ std::move(free_buffers.back()) };
+		free_buffers.pop_back();
+		return buffer;
+	}
+
+	void RomSnapshotQueue::push(Snapshot&& snapshot) {
+		{
+			std::lock_guard lock{ mutex };
+			queued.push_back(std::move(snapshot));
+		}
+		snapshot_available.notify_one();
+	}
+
+	std::optional<RomSnapshotQueue::Snapshot> RomSnapshotQueue::pop(std::stop_token stop_token) {
+		std::unique_lock lock{ mutex };
+		snapshot_available.wait(lock, stop_token, [&] { return !queued.empty() || closed; });
+
+		if (queued.empty() || stop_token.stop_requested()) {
+			return {};
+		}
+
+		auto snapshot{ std::move(queued.front()) };
+		queued.pop_front();
+		return snapshot;
+	}
+
+	void RomSnapshotQueue::recycle(std::vector<char>&& buffer) {
+		{
+			std::lock_guard lock{ mutex };
+			free_buffers.push_back(std::move(buffer));
+		}
+		buffer_available.notify_one();
+	}
+
+	void RomSnapshotQueue::close() {
+		{
+			std::lock_guard lock{ mutex };
+			closed = true;
+		}
+		snapshot_available.notify_all();
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <optional>
+#include <mutex>
+#include <condition_variable>
+#include <stop_token>
+
+#include "../insertable.h"
+
+namespace callisto {
+	// Bounded queue handing ROM snapshots from the build loop to the conflict worker,
+	// buffers are recycled so steady state diffing does not allocate
+	class RomSnapshotQueue {
+	public:
+		// Either a full copy of the ROM or, for insertables that know what they wrote,
+		// just those writes, the latter don't take up a buffer and are not bounded
+		struct Snapshot {
+			std::vector<char> rom;
+			std::optional<std::vector<Insertable::RomWrite>> writes;
+			std::string descriptor_string;
+		};
+
+	protected:
+		std::mutex mutex{};
+		std::condition_variable_any snapshot_available{};
+		std::condition_variable_any buffer_available{};
+
+		std::deque<Snapshot> queued{};
+		std::vector<std::vector<char>> free_buffers{};
+		bool closed{ false };
+
+	public:
+		// capacity is the number of snapshots that may wait in the queue, two additional buffers
+		// are handed out so the consumer can hold the previous and current snapshot while diffing
+		RomSnapshotQueue(size_t capacity);
+
+		// Blocks while every buffer is in use, i.e. while the queue is full
+		std::vector<char> acquireBuffer();
+		void push(Snapshot&& snapshot);
+
+		// Returns nullopt once the queue has been closed and drained or a stop has been requested
+		std::optional<Snapshot> pop(std::stop_token stop_token);
+		void recycle(std::vector<char>&& buffer);
+
+		void close();
+	};
+}
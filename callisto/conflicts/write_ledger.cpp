@@ -0,0 +1,258 @@
+#include "write_ledger.h"
+
+namespace callisto {
+	WriteLedger::WriteLedger() {
+		internWriter(ORIGINAL_BYTES_NAME);
+	}
+
+	WriteLedger::WriterId WriteLedger::internWriter(const std::string& name) {
+		const auto existing{ writer_ids.find(name) };
+		if (existing != writer_ids.end()) {
+			return existing->second;
+		}
+
+		const auto id{ static_cast<WriterId>(writer_names.size()) };
+		writer_names.push_back(name);
+		writer_ids.insert({ name, id });
+		return id;
+	}
+
+	const std::string& WriteLedger::getWriterName(WriterId writer) const {
+		return writer_names.at(writer);
+	}
+
+	void WriteLedger::recordWrite(WriterId writer, int start, int length, const char* old_bytes, const char* new_bytes) {
+		if (length <= 0) {
+			return;
+		}
+
+		// original bytes need to go first so they precede the write in every segment
+		recordOriginalBytes(start, length, old_bytes);
+		addRun(start, length, writer, new_bytes);
+	}
+
+	void WriteLedger::replaceWrites(WriterId writer, const std::vector<Range>& changed_ranges,
+		const char* old_rom, const char* new_rom, size_t rom_size) {
+		const auto is_changed{ [&](size_t address) {
+			const auto next{ std::upper_bound(changed_ranges.begin(), changed_ranges.end(), address,
+				[](size_t address, const Range& range) { return address < range.first; }) };
+			return next != changed_ranges.begin() && address < std::prev(next)->second;
+		} };
+
+		std::vector<std::pair<int, int>> kept{};
+		for (const auto& run : runs) {
+			if (run.writer != writer) {
+				continue;
+			}
+
+			std::optional<int> kept_start{};
+			for (int address{ run.start }; address != run.end(); ++address) {
+				const auto pc_address{ static_cast<size_t>(address) };
+				const bool keep{ pc_address < rom_size && !is_changed(pc_address) &&
+					static_cast<unsigned char>(new_rom[pc_address]) == arena[run.arena_offset + (address - run.start)] };
+
+				if (keep && !kept_start.has_value()) {
+					kept_start = address;
+				}
+				else if (!keep && kept_start.has_value()) {
+					kept.push_back({ kept_start.value(), address - kept_start.value() });
+					kept_start.reset();
+				}
+			}
+			if (kept_start.has_value()) {
+				kept.push_back({ kept_start.value(), run.end() - kept_start.value() });
+			}
+		}
+
+		removeRunsOf(writer);
+
+		for (const auto& [start, end] : changed_ranges) {
+			recordWrite(writer, static_cast<int>(start), static_cast<int>(end - start), old_rom + start, new_rom + start);
+		}
+
+		// these were covered before, so there are already original bytes recorded for them
+		for (const auto& [start, length] : kept) {
+			addRun(start, length, writer, new_rom + start);
+		}
+	}
+
+	void WriteLedger::removeRunsOf(WriterId writer) {
+		std::vector<Run> remaining_runs{};
+		std::vector<unsigned char> remaining_arena{};
+		remaining_arena.reserve(arena.size());
+
+		for (const auto& run : runs) {
+			if (run.writer == writer) {
+				continue;
+			}
+
+			remaining_runs.push_back({ run.start, run.length, run.writer, remaining_arena.size() });
+			remaining_arena.insert(remaining_arena.end(), arena.begin() + run.arena_offset,
+				arena.begin() + run.arena_offset + run.length);
+		}
+
+		runs = std::move(remaining_runs);
+		arena = std::move(remaining_arena);
+	}
+
+	void WriteLedger::addRun(int start, int length, WriterId writer, const char* bytes) {
+		runs.push_back({ start, length, writer, arena.size() });
+		arena.insert(arena.end(), reinterpret_cast<const unsigned char*>(bytes),
+			reinterpret_cast<const unsigned char*>(bytes) + length);
+	}
+
+	void WriteLedger::recordOriginalBytes(int start, int length, const char* old_bytes) {
+		const int end{ start + length };
+
+		auto it{ covered.upper_bound(start) };
+		if (it != covered.begin()) {
+			const auto previous{ std::prev(it) };
+			if (previous->second >= start) {
+				it = previous;
+			}
+		}
+
+		int cursor{ start };
+		int merged_start{ start };
+		int merged_end{ end };
+		while (it != covered.end() && it->first <= end) {
+			if (it->first > cursor) {
+				addRun(cursor, it->first - cursor, ORIGINAL_BYTES_WRITER, old_bytes + (cursor - start));
+			}
+			cursor = std::max(cursor, it->second);
+			merged_start = std::min(merged_start, it->first);
+			merged_end = std::max(merged_end, it->second);
+			it = covered.erase(it);
+		}
+
+		if (cursor < end) {
+			addRun(cursor, end - cursor, ORIGINAL_BYTES_WRITER, old_bytes + (cursor - start));
+		}
+
+		covered.insert({ merged_start, merged_end });
+	}
+
+	std::vector<WriteLedger::Segment> WriteLedger::getSegments() const {
+		struct Event {
+			int address;
+			bool starts;
+			size_t run_index;
+		};
+
+		std::vector<Event> events{};
+		events.reserve(runs.size() * 2);
+		for (size_t i{ 0 }; i != runs.size(); ++i) {
+			events.push_back({ runs[i].start, true, i });
+			events.push_back({ runs[i].end(), false, i });
+		}
+
+		std::sort(events.begin(), events.end(), [](const Event& event1, const Event& event2) {
+			return event1.address < event2.address;
+		});
+
+		const auto in_build_order{ [&](size_t run1, size_t run2) {
+			return std::pair(runs[run1].writer, run1) < std::pair(runs[run2].writer, run2);
+		} };
+
+		std::vector<Segment> segments{};
+		std::set<size_t, decltype(in_build_order)> active(in_build_order);
+		size_t i{ 0 };
+		while (i != events.size()) {
+			const auto address{ events[i].address };
+			while (i != events.size() && events[i].address == address) {
+				if (events[i].starts) {
+					active.insert(events[i].run_index);
+				}
+				else {
+					active.erase(events[i].run_index);
+				}
+				++i;
+			}
+
+			if (!active.empty()) {
+				segments.push_back({ address, events[i].address, std::vector<size_t>(active.begin(), active.end()) });
+			}
+		}
+
+		return segments;
+	}
+
+	void WriteLedger::serialize(std::ostream& out) const {
+		BinaryWriter writer{ out };
+		writer.write<uint32_t>(FORMAT_VERSION);
+
+		writer.write<uint32_t>(static_cast<uint32_t>(writer_names.size()));
+		for (const auto& name : writer_names) {
+			writer.writeString(name);
+		}
+
+		// runs are stored in arena order, so their offsets do not need to be written
+		writer.write<uint64_t>(runs.size());
+		for (const auto& run : runs) {
+			writer.write<int32_t>(run.start);
+			writer.write<int32_t>(run.length);
+			writer.write<uint32_t>(run.writer);
+		}
+
+		writer.write<uint64_t>(arena.size());
+		writer.writeBytes({ reinterpret_cast<const char*>(arena.data()), arena.size() });
+	}
+
+	WriteLedger WriteLedger::deserialize(std::istream& in) {
+		BinaryReader reader{ in, "Write ledger" };
+		if (reader.read<uint32_t>() != FORMAT_VERSION) {
+			throw CallistoException("Write ledger format has changed");
+		}
+
+		WriteLedger ledger{};
+		ledger.writer_names.clear();
+		ledger.writer_ids.clear();
+
+		const auto writer_count{ reader.read<uint32_t>() };
+		for (uint32_t i{ 0 }; i != writer_count; ++i) {
+			ledger.internWriter(reader.readString());
+		}
+
+		if (ledger.writer_names.empty() || ledger.writer_names.front() != ORIGINAL_BYTES_NAME) {
+			throw CallistoException("Write ledger is malformed");
+		}
+
+		const auto run_count{ reader.read<uint64_t>() };
+		size_t arena_offset{ 0 };
+		for (uint64_t i{ 0 }; i != run_count; ++i) {
+			const auto start{ reader.read<int32_t>() };
+			const auto length{ reader.read<int32_t>() };
+			const auto writer{ reader.read<uint32_t>() };
+			if (start < 0 || length <= 0 || writer >= ledger.writer_names.size()) {
+				throw CallistoException("Write ledger is malformed");
+			}
+
+			ledger.runs.push_back({ start, length, writer, arena_offset });
+			arena_offset += length;
+		}
+
+		if (reader.read<uint64_t>() != arena_offset) {
+			throw CallistoException("Write ledger is malformed");
+		}
+		ledger.arena.resize(arena_offset);
+		reader.readBytes({ reinterpret_cast<char*>(ledger.arena.data()), ledger.arena.size() });
+
+		// coverage is not stored since it is just the union of all runs
+		std::vector<std::pair<int, int>> intervals{};
+		for (const auto& run : ledger.runs) {
+			intervals.push_back({ run.start, run.end() });
+		}
+		std::sort(intervals.begin(), intervals.end());
+		for (const auto& [start, end] : intervals) {
+			if (!ledger.covered.empty() && std::prev(ledger.covered.end())->second >= start) {
+				auto& last_end{ std::prev(ledger.covered.end())->second };
+				last_end = std::max(last_end, end);
+			}
+			else {
+				ledger.covered.insert({ start, end });
+			}
+		}
+
+		return ledger;
+	}
+}
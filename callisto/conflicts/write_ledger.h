@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <istream>
+#include <ostream>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <utility>
+#include <map>
+#include <set>
+#include <optional>
+#include <unordered_map>
+#include <cstdint>
+#include <stdexcept>
+
+#include "../callisto_exception.h"
+#include "../binary_io.h"
+
+namespace callisto {
+	// Records which writer changed which bytes of the ROM as runs of consecutive bytes
+	// instead of one entry per byte, writer names are interned and written bytes live
+	// in a single shared arena
+	//
+	// Writers are expected to be interned in build order, since that is the order
+	// their runs are listed in within a segment
+	class WriteLedger {
+	public:
+		using WriterId = uint32_t;
+		using Range = std::pair<size_t, size_t>;
+
+		static constexpr uint32_t FORMAT_VERSION{ 2 };
+
+		static constexpr auto ORIGINAL_BYTES_NAME{ "Original bytes" };
+		static constexpr WriterId ORIGINAL_BYTES_WRITER{ 0 };
+
+		struct Run {
+			int start;
+			int length;
+			WriterId writer;
+			size_t arena_offset;
+
+			int end() const {
+				return start + length;
+			}
+		};
+
+		// Maximal address range [start, end) throughout which the same runs are active,
+		// runs are listed by writer and then in the order they were recorded in
+		struct Segment {
+			int start;
+			int end;
+			std::vector<size_t> runs;
+		};
+
+	protected:
+		std::vector<std::string> writer_names{};
+		std::unordered_map<std::string, WriterId> writer_ids{};
+
+		std::vector<Run> runs{};
+		std::vector<unsigned char> arena{};
+
+		// start -> end of merged address ranges that have been written to at least once
+		std::map<int, int> covered{};
+
+		void addRun(int start, int length, WriterId writer, const char* bytes);
+		void recordOriginalBytes(int start, int length, const char* old_bytes);
+		void removeRunsOf(WriterId writer);
+
+	public:
+		WriteLedger();
+
+		WriterId internWriter(const std::string& name);
+		const std::string& getWriterName(WriterId writer) const;
+
+		// old_bytes and new_bytes both point to the byte at address start
+		void recordWrite(WriterId writer, int start, int length, const char* old_bytes, const char* new_bytes);
+
+		// Replaces everything previously recorded for writer by the passed changed ranges between old_rom and new_rom,
+		// previously written bytes that still hold the same value are kept, since rewriting a byte with the value
+		// it already has does not show up in a diff
+		void replaceWrites(WriterId writer, const std::vector<Range>& changed_ranges,
+			const char* old_rom, const char* new_rom, size_t rom_size);
+
+		std::vector<Segment> getSegments() const;
+
+		const Run& getRun(size_t run_index) const {
+			return runs[run_index];
+		}
+
+		unsigned char getByte(size_t run_index, int address) const {
+			const auto& run{ runs[run_index] };
+			return arena[run.arena_offset + (address - run.start)];
+		}
+
+		const unsigned char* getBytes(size_t run_index, int address) const {
+			const auto& run{ runs[run_index] };
+			return arena.data() + run.arena_offset + (address - run.start);
+		}
+
+		bool empty() const {
+			return runs.empty();
+		}
+
+		void serialize(std::ostream& out) const;
+		static WriteLedger deserialize(std::istream& in);
+	};
+}
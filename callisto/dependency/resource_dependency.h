@@ -6,6 +6,11 @@
 #include <functional>
 #include <optional>
 #include <chrono>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 
 #include <spdlog/spdlog.h>
 #include <fmt/format.h>
@@ -13,23 +18,106 @@
 
 #include "../not_found_exception.h"
 #include "../dependency/policy.h"
+#include "../path_util.h"
+#include "../cache/hasher.h"
+#include "../cache/git_index.h"
 
 namespace fs = std::filesystem;
 using json = nlohmann::json;
 
 namespace callisto {
 	class ResourceDependency {
+	protected:
+		static std::optional<uint64_t> writeTimeOf(const fs::path& path) {
+			return fs::exists(path) ? std::make_optional(fs::last_write_time(path).time_since_epoch().count()) : std::nullopt;
+		}
+
+		static std::optional<uintmax_t> sizeOf(const fs::path& path) {
+			return fs::is_regular_file(path) ? std::make_optional(fs::file_size(path)) : std::nullopt;
+		}
+
+		// A folder's write time only changes when entries are added, removed or renamed, so its listing is all that's hashed
+		static std::optional<Hasher::Hash> hashContents(const fs::path& path) {
+			if (fs::is_regular_file(path)) {
+				return Hasher::hashFile(path);
+			}
+			if (!fs::is_directory(path)) {
+				return {};
+			}
+
+			std::vector<std::string> names{};
+			for (const auto& entry : fs::directory_iterator(path)) {
+				names.push_back(entry.path().filename().generic_string());
+			}
+			std::sort(names.begin(), names.end());
+
+			Hasher hasher{};
+			hasher.updateValue(names.size());
+			for (const auto& name : names) {
+				hasher.updateString(name);
+			}
+			return hasher.digest();
+		}
+
+	public:
+		// What the resource's contents were like, all empty for missing resources and reports written before they were recorded
+		struct ContentStamp {
+			std::optional<uintmax_t> size;
+			// Not computed for files that have a git blob id, which already identifies their contents
+			std::optional<Hasher::Hash> content_hash;
+			// Only for files git tracks and considers unmodified, see GitIndex
+			std::optional<std::string> git_blob;
+		};
+
+	protected:
+		// Reading the contents is only worth it once the stamp is needed, i.e. when a dependency makes it into a
+		// report, and many dependencies are created on the same paths, so stamps are computed once per path and write time
+		static ContentStamp currentStampOf(const fs::path& path, std::optional<uint64_t> last_write_time) {
+			static std::mutex mutex{};
+			static std::unordered_map<std::string, std::pair<std::optional<uint64_t>, ContentStamp>> stamps{};
+
+			const auto key{ path.string() };
+			{
+				std::lock_guard lock{ mutex };
+				const auto stamp{ stamps.find(key) };
+				if (stamp != stamps.end() && stamp->second.first == last_write_time) {
+					return stamp->second.second;
+				}
+			}
+
+			// changed since the dependency was created, whatever is there now isn't what the dependency was on
+			if (writeTimeOf(path) != last_write_time) {
+				return {};
+			}
+
+			ContentStamp stamp{ sizeOf(path), std::nullopt, GitIndex::getCleanBlobId(path) };
+			if (!stamp.git_blob.has_value()) {
+				stamp.content_hash = hashContents(path);
+			}
+
+			std::lock_guard lock{ mutex };
+			stamps.insert_or_assign(key, std::make_pair(last_write_time, stamp));
+			return stamp;
+		}
+
 	public:
 		const fs::path dependent_path;
 		const std::optional<uint64_t> last_write_time;
 		const Policy policy;
 
+	protected:
+		// Set for dependencies read from a report, the others look at the resource once their stamp is needed
+		const std::optional<ContentStamp> recorded_stamp;
+
+		ResourceDependency(const fs::path& dependent_path, Policy policy, std::optional<uint64_t> last_write_time,
+			ContentStamp recorded_stamp)
+			: dependent_path(dependent_path), last_write_time(last_write_time), policy(policy), recorded_stamp(recorded_stamp) {}
+
+	public:
 		ResourceDependency(const fs::path& dependent_path) : ResourceDependency(dependent_path, Policy::REINSERT) {}
 
 		ResourceDependency(const fs::path& dependent_path, Policy policy)
-			: dependent_path(dependent_path), policy(policy),
-			last_write_time(fs::exists(dependent_path) ? 
-				std::make_optional(fs::last_write_time(dependent_path).time_since_epoch().count()) : std::nullopt)
+			: dependent_path(dependent_path), policy(policy), last_write_time(writeTimeOf(dependent_path))
 		{
 			spdlog::debug(fmt::format("Resource dependency created on '{}' -> {}", 
 				dependent_path.string(), 
@@ -37,12 +125,25 @@ namespace callisto {
 			));
 		}
 
-		ResourceDependency(const json& j) : dependent_path(j["path"].get<std::string>()), policy(j["policy"]), 
-			last_write_time(j["timestamp"].is_null() ? std::nullopt : std::make_optional(j["timestamp"].get<uint64_t>())) {}
+		// Paths are stored relative to the project root, so a report stays valid for other clones of the project
+		ResourceDependency(const json& j, const fs::path& project_root) 
+			: dependent_path(PathUtil::fromPortable(j["path"].get<std::string>(), project_root)), policy(j["policy"]), 
+			last_write_time(j["timestamp"].is_null() ? std::nullopt : std::make_optional(j["timestamp"].get<uint64_t>())),
+			recorded_stamp(ContentStamp{
+				!j.contains("size") || j["size"].is_null() ? std::nullopt : std::make_optional(j["size"].get<uintmax_t>()),
+				!j.contains("hash") || j["hash"].is_null() ? std::nullopt :
+					std::make_optional(std::stoull(j["hash"].get<std::string>(), nullptr, 16)),
+				!j.contains("git_blob") || j["git_blob"].is_null() ? std::nullopt :
+					std::make_optional(j["git_blob"].get<std::string>())
+			}) {}
 
-		json toJson() const {
+		ContentStamp getContentStamp() const {
+			return recorded_stamp.has_value() ? recorded_stamp.value() : currentStampOf(dependent_path, last_write_time);
+		}
+
+		json toJson(const fs::path& project_root) const {
 			json j;
-			j["path"] = dependent_path.string();
+			j["path"] = PathUtil::toPortable(dependent_path, project_root);
 			j["policy"] = policy;
 			if (last_write_time.has_value()) {
 				j["timestamp"] = last_write_time.value();
@@ -50,9 +151,52 @@ namespace callisto {
 			else {
 				j["timestamp"] = nullptr;
 			}
+			const auto stamp{ getContentStamp() };
+			j["size"] = stamp.size.has_value() ? json(stamp.size.value()) : json(nullptr);
+			j["hash"] = stamp.content_hash.has_value() ? json(Hasher::toHex(stamp.content_hash.value())) : json(nullptr);
+			j["git_blob"] = stamp.git_blob.has_value() ? json(stamp.git_blob.value()) : json(nullptr);
 			return j;
 		}
 
+		// Whether the resource still has the write time and size it had when this was created, checking this
+		// is cheap, but a checkout or a fresh clone changes write times without changing contents
+		bool hasSameStamp() const {
+			if (!fs::exists(dependent_path)) {
+				return !last_write_time.has_value();
+			}
+			if (last_write_time != static_cast<uint64_t>(fs::last_write_time(dependent_path).time_since_epoch().count())) {
+				return false;
+			}
+			const auto size{ getContentStamp().size };
+			return !size.has_value() || size == sizeOf(dependent_path);
+		}
+
+		// The same dependency under the resource's current write time and size, for when its contents are known to be unchanged
+		ResourceDependency restamped() const {
+			auto stamp{ getContentStamp() };
+			stamp.size = sizeOf(dependent_path);
+			return ResourceDependency(dependent_path, policy, writeTimeOf(dependent_path), stamp);
+		}
+
+		bool hasSameContents(const ResourceDependency& other) const {
+			const auto stamp{ getContentStamp() };
+			const auto other_stamp{ other.getContentStamp() };
+			if (stamp.git_blob.has_value() && other_stamp.git_blob.has_value()) {
+				return stamp.git_blob == other_stamp.git_blob;
+			}
+
+			// a tracked file git no longer considers unmodified may still have the same contents, e.g. after being
+			// touched, since only its blob id was recorded, the blob id of what's there now is what it's compared by
+			if (stamp.git_blob.has_value() && !other.recorded_stamp.has_value()) {
+				return GitIndex::hasBlobContents(other.dependent_path, stamp.git_blob.value());
+			}
+			if (other_stamp.git_blob.has_value() && !recorded_stamp.has_value()) {
+				return GitIndex::hasBlobContents(dependent_path, other_stamp.git_blob.value());
+			}
+
+			return stamp.content_hash.has_value() && stamp.content_hash == other_stamp.content_hash;
+		}
+
 		bool operator==(const ResourceDependency& other) const {
 			return dependent_path == other.dependent_path && last_write_time == other.last_write_time;
 		}
@@ -6,6 +6,7 @@
 #include <nlohmann/json.hpp>
 
 #include "symbol.h"
+#include "path_util.h"
 
 namespace fs = std::filesystem;
 using json = nlohmann::json;
@@ -21,6 +22,10 @@ namespace callisto {
 			return name.has_value();
 		}
 
+		bool hasNameAsPath() const {
+			return hasName() && (symbol == Symbol::PATCH || symbol == Symbol::MODULE);
+		}
+
 		bool operator==(const Descriptor& other) const {
 			return symbol == other.symbol && name == other.name;
 		}
@@ -32,15 +37,23 @@ namespace callisto {
 		Descriptor(Symbol symbol, const std::optional<std::string>& name = {})
 			: symbol(symbol), name(name) {}
 
-		Descriptor(const json& j)
-			: symbol(j["symbol"]), name(j["name"].is_null() ? std::nullopt : std::make_optional(j["name"])) {}
+		// Patch and module names are paths, these are stored relative to the project root
+		Descriptor(const json& j, const fs::path& project_root)
+			: symbol(j["symbol"]), name(j["name"].is_null() ? std::nullopt : std::make_optional(j["name"])) {
+			if (hasNameAsPath()) {
+				name = PathUtil::fromPortable(name.value(), project_root).string();
+			}
+		}
 
-		json toJson() const {
+		json toJson(const fs::path& project_root) const {
 			auto j{ json({
 				{"symbol", symbol},
 			}) };
 
-			if (hasName()) {
+			if (hasNameAsPath()) {
+				j["name"] = PathUtil::toPortable(name.value(), project_root);
+			}
+			else if (hasName()) {
 				j["name"] = name.value();
 			}
 			else {
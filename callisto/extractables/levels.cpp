@@ -44,27 +44,21 @@ namespace callisto {
 		}
 
 		std::vector<size_t> Levels::determineModifiedOffsets(const fs::path& extracting_rom) {
-			const auto rom_size{ fs::file_size(extracting_rom) };
-			const auto header_size{ rom_size & 0x7FFF };
+			const MappedRom mapped_rom{ extracting_rom };
+			const RomView rom{ mapped_rom.getBody() };
+			const auto header_size{ mapped_rom.getHeader().size() };
 
-			std::ifstream rom_file{ extracting_rom };
-			rom_file.seekg(header_size + LAYER_1_POINTERS_OFFSET + LAYER_1_POINTER_SIZE - 1);
+			const auto pointers{ rom.view(LAYER_1_POINTERS_OFFSET, LAYER_1_POINTER_SIZE * LAYER_1_POINTERS_AMOUNT) };
 
+			// offsets are returned into the headered file since that's what the chunked ROMs are patched through
 			std::vector<size_t> modified_offsets{};
-			auto curr_position{ header_size + LAYER_1_POINTERS_OFFSET };
-			for (auto i{ 0 }; i != LAYER_1_POINTERS_AMOUNT; ++i) {
-				char bank_byte;
-				rom_file.read(&bank_byte, 1);
-				if (static_cast<uint8_t>(bank_byte) >= 0x10) {
-					modified_offsets.push_back(curr_position);
+			for (size_t i{ 0 }; i != LAYER_1_POINTERS_AMOUNT; ++i) {
+				const auto bank_byte{ static_cast<uint8_t>(pointers[i * LAYER_1_POINTER_SIZE + LAYER_1_POINTER_SIZE - 1]) };
+				if (bank_byte >= 0x10) {
+					modified_offsets.push_back(header_size + LAYER_1_POINTERS_OFFSET + i * LAYER_1_POINTER_SIZE);
 				}
-
-				curr_position += LAYER_1_POINTER_SIZE;
-				rom_file.seekg(LAYER_1_POINTER_SIZE - 1, std::ios_base::cur);
 			}
 
-			rom_file.close();
-
 			return modified_offsets;
 		}
 
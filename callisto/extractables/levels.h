@@ -11,6 +11,8 @@
 #include "extraction_exception.h"
 #include "../not_found_exception.h"
 #include "level.h"
+#include "../rom/mapped_rom.h"
+#include "../rom/rom_view.h"
 
 namespace fs = std::filesystem;
 
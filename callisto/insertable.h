@@ -2,6 +2,8 @@
 
 #include <string>
 #include <unordered_set>
+#include <vector>
+#include <optional>
 
 #include "dependency/configuration_dependency.h"
 #include "configuration/config_variable.h"
@@ -16,6 +18,12 @@ namespace callisto {
 		class NoDependencyReportFound : public CallistoException {
 			using CallistoException::CallistoException;
 		};
+
+		// Contiguous bytes written to the unheadered ROM
+		struct RomWrite {
+			size_t pc_offset;
+			std::vector<char> bytes;
+		};
 	protected:
 		std::unordered_set<ConfigurationDependency> configuration_dependencies{};
 
@@ -113,6 +121,22 @@ namespace callisto {
 			return configuration_dependencies;
 		}
 
+		// Asks insertables that can report their writes to do so for the coming insertions, so the ones that
+		// can't afford to keep track of them otherwise only pay for it when conflicts are being checked
+		virtual void trackRomWrites() {}
+
+		// Insertables that know exactly what they wrote during their last insertion hand it over here,
+		// so conflict detection doesn't have to diff the whole ROM after them, nullopt if they don't know
+		virtual std::optional<std::vector<RomWrite>> takeRomWrites() {
+			return {};
+		}
+
+		// Insertables that work on the builder's in-memory ROM image instead of the temporary ROM file,
+		// for all others the builder writes the image out beforehand and reloads it afterwards
+		virtual bool usesRomImage() const {
+			return false;
+		}
+
 		virtual ~Insertable() {}
 	};
 }
@@ -1,8 +1,9 @@
 #include "binary_map16.h"
 
 namespace callisto {
-	BinaryMap16::BinaryMap16(const Configuration& config)
-		: LunarMagicInsertable(config), 
+	BinaryMap16::BinaryMap16(const Configuration& config, std::shared_ptr<RomImage> rom_image,
+		std::shared_ptr<StepCache> step_cache)
+		: LunarMagicInsertable(config, rom_image, step_cache), 
 		map16_file_path(registerConfigurationDependency(config.map16, Policy::REINSERT).getOrThrow())
 	{
 		registerConfigurationDependency(config.use_text_map16_format, Policy::REINSERT);
@@ -14,7 +15,7 @@ namespace callisto {
 		return dependencies;
 	}
 
-	void BinaryMap16::insert() {
+	void BinaryMap16::insertIntoRomFile() {
 		checkLunarMagicExists();
 
 		if (!fs::exists(map16_file_path)) {
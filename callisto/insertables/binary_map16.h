@@ -21,10 +21,10 @@ namespace callisto {
 		const fs::path map16_file_path;
 
 		std::unordered_set<ResourceDependency> determineDependencies() override;
+		void insertIntoRomFile() override;
 
 	public:
-		void insert() override;
-
-		BinaryMap16(const Configuration& config);
+		BinaryMap16(const Configuration& config, std::shared_ptr<RomImage> rom_image = nullptr,
+			std::shared_ptr<StepCache> step_cache = nullptr);
 	};
 }
@@ -1,8 +1,9 @@
 #include "exgraphics.h"
 
 namespace callisto {
-	ExGraphics::ExGraphics(const Configuration& config)
-		: LunarMagicInsertable(config),
+	ExGraphics::ExGraphics(const Configuration& config, std::shared_ptr<RomImage> rom_image,
+		std::shared_ptr<StepCache> step_cache)
+		: LunarMagicInsertable(config, rom_image, step_cache),
 		project_exgraphics_folder_path(GraphicsUtil::getExportFolderPath(config, true)),
 		config(config)
 	{
@@ -23,7 +24,7 @@ namespace callisto {
 		return dependencies;
 	}
 
-	void ExGraphics::insert() {
+	void ExGraphics::insertIntoRomFile() {
 		checkLunarMagicExists();
 
 		if (!fs::exists(project_exgraphics_folder_path)) {
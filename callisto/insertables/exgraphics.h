@@ -24,10 +24,10 @@ namespace callisto {
 		const Configuration& config;
 
 		std::unordered_set<ResourceDependency> determineDependencies() override;
+		void insertIntoRomFile() override;
 
 	public:
-		void insert() override;
-
-		ExGraphics(const Configuration& config);
+		ExGraphics(const Configuration& config, std::shared_ptr<RomImage> rom_image = nullptr,
+			std::shared_ptr<StepCache> step_cache = nullptr);
 	};
 }
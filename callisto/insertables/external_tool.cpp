@@ -1,7 +1,8 @@
 #include "external_tool.h"
 
 namespace callisto {
-	ExternalTool::ExternalTool(const std::string& name, const Configuration& config, const ToolConfiguration& tool_config)
+	ExternalTool::ExternalTool(const std::string& name, const Configuration& config, const ToolConfiguration& tool_config,
+		std::shared_ptr<RomImage> rom_image, std::shared_ptr<StepCache> step_cache)
 		: tool_name(name), tool_exe_path(tool_config.executable.getOrThrow()),
 		tool_options(tool_config.options.getOrDefault("")),
 		working_directory(tool_config.working_directory.getOrThrow()),
@@ -9,7 +10,11 @@ namespace callisto {
 		pass_rom(tool_config.pass_rom.getOrDefault(true)),
 		temporary_rom(PathUtil::getTemporaryRomPath(config.temporary_folder.getOrThrow(), config.output_rom.getOrThrow())),
 		static_dependencies(tool_config.static_dependencies.getOrDefault({})),
-		dependency_report_file_path(tool_config.dependency_report_file.getOrDefault({}))
+		dependency_report_file_path(tool_config.dependency_report_file.getOrDefault({})),
+		cached_outputs(tool_config.cached_outputs.getOrDefault({})),
+		rom_image(rom_image),
+		// a tool that asks the user things can't be replayed
+		step_cache(tool_config.cache.getOrDefault(false) && !take_user_input ? step_cache : nullptr)
 	{
 		registerConfigurationDependency(tool_config.executable);
 		registerConfigurationDependency(tool_config.options, Policy::REINSERT);
@@ -45,7 +50,55 @@ namespace callisto {
 		return dependencies;
 	}
 
+	StepCache::Inputs ExternalTool::getCacheInputs() const {
+		StepCache::Inputs inputs{
+			{
+				tool_exe_path.string(),
+				fmt::format("options={}", tool_options),
+				fmt::format("directory={}", working_directory.string()),
+				fmt::format("pass_rom={}", pass_rom)
+			},
+			{ tool_exe_path },
+			dependency_report_file_path,
+			cached_outputs,
+			// e.g. the .ssc, .mwt, .mw2 and .s16 files PIXI writes next to the ROM, which moveTempToOutput picks up
+			pass_rom ? std::optional<fs::path>(temporary_rom) : std::nullopt
+		};
+
+		for (const auto& static_dependency : static_dependencies) {
+			inputs.files.push_back(static_dependency.dependent_path);
+		}
+
+		return inputs;
+	}
+
 	void ExternalTool::insert() {
+		if (rom_image == nullptr) {
+			runTool();
+			return;
+		}
+
+		if (step_cache != nullptr) {
+			const auto inputs{ getCacheInputs() };
+			const auto result{ step_cache->lookup(inputs, rom_image->getBody()) };
+			if (result.has_value()) {
+				step_cache->restoreOutputs(inputs, result.value());
+				rom_image->applyDelta(result.value().delta);
+				spdlog::info(fmt::format(colors::PARTIAL_SUCCESS, "Applied {} result from cache!", tool_name));
+				return;
+			}
+		}
+
+		rom_image->flush();
+		runTool();
+		rom_image->reload();
+
+		if (step_cache != nullptr) {
+			step_cache->record(rom_image->getBody());
+		}
+	}
+
+	void ExternalTool::runTool() {
 		if (!fs::exists(temporary_rom)) {
 			throw RomNotFoundException(fmt::format(
 				colors::EXCEPTION,
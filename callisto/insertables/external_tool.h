@@ -16,6 +16,8 @@
 #include "../dependency/policy.h"
 #include "../dependency/resource_dependency.h"
 #include "../path_util.h"
+#include "../rom/rom_image.h"
+#include "../cache/step_cache.h"
 
 namespace fs = std::filesystem;
 namespace bp = boost::process;
@@ -32,12 +34,23 @@ namespace callisto {
 		bool pass_rom;
 		const std::vector<ResourceDependency> static_dependencies;
 		const std::optional<fs::path> dependency_report_file_path;
+		const std::vector<fs::path> cached_outputs;
+		const std::shared_ptr<RomImage> rom_image;
+		const std::shared_ptr<StepCache> step_cache;
 
 		std::unordered_set<ResourceDependency> determineDependencies() override;
 
+		void runTool();
+		StepCache::Inputs getCacheInputs() const;
+
 	public:
-		ExternalTool(const std::string& name, const Configuration& config, const ToolConfiguration& tool_config);
+		ExternalTool(const std::string& name, const Configuration& config, const ToolConfiguration& tool_config,
+			std::shared_ptr<RomImage> rom_image = nullptr, std::shared_ptr<StepCache> step_cache = nullptr);
 
 		void insert() override;
+
+		bool usesRomImage() const override {
+			return rom_image != nullptr;
+		}
 	};
 }
@@ -1,12 +1,15 @@
 #include "flips_insertable.h"
 
 namespace callisto {
-	FlipsInsertable::FlipsInsertable(const Configuration& config, const PathConfigVariable& bps_patch_path)
-		: LunarMagicInsertable(config), 
+	FlipsInsertable::FlipsInsertable(const Configuration& config, const PathConfigVariable& bps_patch_path,
+		std::shared_ptr<RomImage> rom_image, std::shared_ptr<StepCache> step_cache,
+		std::shared_ptr<GraphicsBaseImage> graphics_base_image)
+		: LunarMagicInsertable(config, rom_image, step_cache), 
 		flips_path(registerConfigurationDependency(config.flips_path).getOrThrow()), 
 		clean_rom_path(registerConfigurationDependency(config.clean_rom).getOrThrow()), 
 		bps_patch_path(registerConfigurationDependency(bps_patch_path).getOrThrow()),
-		config(config)
+		config(config),
+		graphics_base_image(graphics_base_image)
 	{
 		for (const auto& descriptor : config.build_order) {
 			if (descriptor.symbol == Symbol::GRAPHICS) {
@@ -26,6 +29,18 @@ namespace callisto {
 		return dependencies;
 	}
 
+	StepCache::Inputs FlipsInsertable::getCacheInputs() {
+		auto inputs{ LunarMagicInsertable::getCacheInputs() };
+		// the patched ROM gets the project's graphics imported before its data is transferred
+		if (needs_gfx) {
+			inputs.files.push_back(GraphicsUtil::getExportFolderPath(config, false));
+		}
+		if (needs_exgfx) {
+			inputs.files.push_back(GraphicsUtil::getExportFolderPath(config, true));
+		}
+		return inputs;
+	}
+
 	void FlipsInsertable::checkPatchExists() const {
 		if (!fs::exists(bps_patch_path)) {
 			throw ResourceNotFoundException(fmt::format(
@@ -96,6 +111,30 @@ namespace callisto {
 		return rom_path;
 	}
 
+	bool FlipsInsertable::createTemporaryPatchedRomFromGraphicsBase() {
+		try {
+			const auto patched_rom{ graphics_base_image->applyPatch(clean_rom_path, bps_patch_path) };
+			if (!patched_rom.has_value()) {
+				return false;
+			}
+
+			const auto rom_path{ getTemporaryPatchedRomPath() };
+			std::ofstream rom_file{ rom_path, std::ios::out | std::ios::binary };
+			rom_file.write(patched_rom.value().data(), patched_rom.value().size());
+			if (!rom_file) {
+				throw CallistoException(fmt::format("Failed to write temporary {} ROM to {}", getResourceName(), rom_path.string()));
+			}
+
+			spdlog::debug("Created temporary {} ROM from graphics base ROM", getResourceName());
+			temporary_patched_rom_path = rom_path;
+			return true;
+		}
+		catch (const std::exception& e) {
+			spdlog::debug("Failed to create temporary {} ROM from graphics base ROM: {}", getResourceName(), e.what());
+			return false;
+		}
+	}
+
 	void FlipsInsertable::deleteTemporaryPatchedRom(const fs::path& temporary_patch_path) const {
 		try {
 			fs::remove(temporary_patch_path);
@@ -110,7 +149,12 @@ namespace callisto {
 		}
 	}
 
-	void FlipsInsertable::init() {
+	void FlipsInsertable::createPatchedRom() {
+		// saves every FlipsInsertable importing all graphics into its own patched ROM
+		if (graphics_base_image != nullptr && (needs_gfx || needs_exgfx) && createTemporaryPatchedRomFromGraphicsBase()) {
+			return;
+		}
+
 		temporary_patched_rom_path = createTemporaryPatchedRom();
 
 		if (needs_gfx) {
@@ -122,7 +166,14 @@ namespace callisto {
 		}
 	}
 
-	void FlipsInsertable::insert() {
+	void FlipsInsertable::init() {
+		// if the transfer may come from the step cache, the patched ROM is only created once that missed
+		if (step_cache == nullptr || rom_image == nullptr) {
+			createPatchedRom();
+		}
+	}
+
+	void FlipsInsertable::insertIntoRomFile() {
 		if (!fs::exists(flips_path)) {
 			throw ToolNotFoundException(fmt::format(
 				colors::EXCEPTION,
@@ -139,6 +190,10 @@ namespace callisto {
 			));
 		}
 
+		if (!fs::exists(temporary_patched_rom_path)) {
+			createPatchedRom();
+		}
+
 		spdlog::info(fmt::format(colors::RESOURCE, "Inserting {}", getResourceName()));
 		spdlog::debug(fmt::format(
 			"Inserting {} from BPS patch {} into temporary ROM {}",
@@ -14,6 +14,7 @@
 #include "rom_insertable.h"
 
 #include "../graphics_util.h"
+#include "graphics_base_image.h"
 
 #include "../configuration/configuration.h"
 #include "../dependency/policy.h"
@@ -30,13 +31,16 @@ namespace callisto {
 		fs::path temporary_patched_rom_path;
 
 		const Configuration& config;
+		const std::shared_ptr<GraphicsBaseImage> graphics_base_image;
 
 		bool needs_exgfx{ false };
 		bool needs_gfx{ false };
 
 		fs::path getTemporaryPatchedRomPath() const;
 		fs::path createTemporaryPatchedRom() const;
+		bool createTemporaryPatchedRomFromGraphicsBase();
 		void deleteTemporaryPatchedRom(const fs::path& patched_rom_path) const;
+		void createPatchedRom();
 
 		virtual inline std::string getTemporaryPatchedRomPostfix() const = 0;
 		virtual inline std::string getLunarMagicFlag() const = 0;
@@ -46,12 +50,15 @@ namespace callisto {
 
 		void checkPatchExists() const;
 
-		FlipsInsertable(const Configuration& config, const PathConfigVariable& bps_patch_path);
+		FlipsInsertable(const Configuration& config, const PathConfigVariable& bps_patch_path,
+			std::shared_ptr<RomImage> rom_image, std::shared_ptr<StepCache> step_cache,
+			std::shared_ptr<GraphicsBaseImage> graphics_base_image);
 
 		std::unordered_set<ResourceDependency> determineDependencies() override;
+		void insertIntoRomFile() override;
+		StepCache::Inputs getCacheInputs() override;
 
 	public:
 		void init() override;
-		void insert() override;
 	};
 }
@@ -24,8 +24,9 @@ namespace callisto {
 		}
 
 	public:
-		GlobalExAnimation(const Configuration& config)
-			: FlipsInsertable(config, config.global_exanimation)
+		GlobalExAnimation(const Configuration& config, std::shared_ptr<RomImage> rom_image = nullptr,
+			std::shared_ptr<StepCache> step_cache = nullptr, std::shared_ptr<GraphicsBaseImage> graphics_base_image = nullptr)
+			: FlipsInsertable(config, config.global_exanimation, rom_image, step_cache, graphics_base_image)
 		{
 			checkPatchExists();
 		}
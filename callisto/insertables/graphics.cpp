@@ -1,8 +1,9 @@
 #include "graphics.h"
 
 namespace callisto {
-	Graphics::Graphics(const Configuration& config)
-		: LunarMagicInsertable(config), 
+	Graphics::Graphics(const Configuration& config, std::shared_ptr<RomImage> rom_image,
+		std::shared_ptr<StepCache> step_cache)
+		: LunarMagicInsertable(config, rom_image, step_cache), 
 		project_graphics_folder_path(GraphicsUtil::getExportFolderPath(config, false)),
 		config(config)
 	{
@@ -23,7 +24,7 @@ namespace callisto {
 		return dependencies;
 	}
 
-	void Graphics::insert() {
+	void Graphics::insertIntoRomFile() {
 		checkLunarMagicExists();
 
 		if (!fs::exists(project_graphics_folder_path)) {
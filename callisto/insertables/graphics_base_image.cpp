@@ -0,0 +1,152 @@
+#include "graphics_base_image.h"
+
+namespace callisto {
+	GraphicsBaseImage::GraphicsBaseImage(const Configuration& config, std::shared_ptr<BaseImageCache> base_image_cache)
+		: config(config), base_image_cache(base_image_cache)
+	{
+		for (const auto& descriptor : config.build_order) {
+			if (descriptor.symbol == Symbol::GRAPHICS) {
+				needs_gfx = true;
+			}
+			if (descriptor.symbol == Symbol::EX_GRAPHICS) {
+				needs_exgfx = true;
+			}
+		}
+	}
+
+	Hasher::Hash GraphicsBaseImage::fingerprintFolder(const fs::path& folder) {
+		std::vector<std::pair<std::string, Hasher::Hash>> files{};
+		for (const auto& entry : fs::recursive_directory_iterator(folder)) {
+			if (entry.is_regular_file()) {
+				files.push_back({ entry.path().lexically_relative(folder).generic_string(), Hasher::hashFile(entry.path()) });
+			}
+		}
+		std::sort(files.begin(), files.end());
+
+		Hasher hasher{};
+		hasher.updateValue(files.size());
+		for (const auto& [name, hash] : files) {
+			hasher.updateString(name);
+			hasher.updateValue(hash);
+		}
+		return hasher.digest();
+	}
+
+	std::vector<char> GraphicsBaseImage::readFile(const fs::path& path) {
+		std::ifstream file{ path, std::ios::in | std::ios::binary };
+		if (!file) {
+			throw CallistoException(fmt::format("Failed to read {}", path.string()));
+		}
+		return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	Hasher::Hash GraphicsBaseImage::identify() const {
+		Hasher hasher{};
+		hasher.updateValue(FORMAT_VERSION);
+		// a different Lunar Magic version may well import differently
+		hasher.updateValue(Hasher::hashFile(config.lunar_magic_path.getOrThrow()));
+
+		hasher.updateValue(needs_gfx);
+		if (needs_gfx) {
+			hasher.updateValue(fingerprintFolder(GraphicsUtil::getExportFolderPath(config, false)));
+		}
+		hasher.updateValue(needs_exgfx);
+		if (needs_exgfx) {
+			hasher.updateValue(fingerprintFolder(GraphicsUtil::getExportFolderPath(config, true)));
+		}
+		return hasher.digest();
+	}
+
+	std::vector<char> GraphicsBaseImage::build() const {
+		const auto& clean_rom_path{ config.clean_rom.getOrThrow() };
+		const auto image_path{ config.temporary_folder.getOrThrow() / IMAGE_FILE_NAME };
+		const auto clean_rom_hash{ Hasher::hashFile(clean_rom_path) };
+		const auto key{ identify() };
+
+		if (base_image_cache == nullptr || !base_image_cache->restore(clean_rom_hash, key, image_path)) {
+			spdlog::debug("Creating graphics base ROM {}", image_path.string());
+			fs::copy_file(clean_rom_path, image_path, fs::copy_options::overwrite_existing);
+
+			if (needs_gfx) {
+				GraphicsUtil::importProjectGraphicsInto(config, image_path);
+			}
+			if (needs_exgfx) {
+				GraphicsUtil::importProjectExGraphicsInto(config, image_path);
+			}
+
+			if (base_image_cache != nullptr) {
+				base_image_cache->record(clean_rom_hash, key, image_path);
+			}
+		}
+
+		auto image_contents{ readFile(image_path) };
+		fs::remove(image_path);
+		return image_contents;
+	}
+
+	const std::optional<std::vector<char>>& GraphicsBaseImage::get() {
+		std::lock_guard lock{ mutex };
+		if (!attempted) {
+			attempted = true;
+			try {
+				image = build();
+			}
+			catch (const std::exception& e) {
+				spdlog::debug("Failed to create graphics base ROM, graphics will be imported into each patched ROM instead: {}",
+					e.what());
+			}
+		}
+		return image;
+	}
+
+	std::optional<std::vector<char>> GraphicsBaseImage::applyPatch(const fs::path& clean_rom_path, const fs::path& bps_patch_path) {
+		const auto& base{ get() };
+		if (!base.has_value()) {
+			return {};
+		}
+
+		const auto clean_rom{ readFile(clean_rom_path) };
+		const auto patch{ readFile(bps_patch_path) };
+		const auto clean_header_size{ headerSize(clean_rom.size()) };
+
+		std::vector<char> patched_rom{};
+		try {
+			patched_rom = BpsPatch::apply(clean_rom, patch);
+		}
+		catch (const BpsPatch::InvalidPatch& e) {
+			if (clean_header_size == 0) {
+				spdlog::debug("BPS patch {} can't be applied in memory: {}", bps_patch_path.string(), e.what());
+				return {};
+			}
+			// the patch may have been made from the unheadered ROM, which is what FLIPS falls back to as well
+			try {
+				patched_rom = BpsPatch::apply(std::span(clean_rom).subspan(clean_header_size), patch);
+			}
+			catch (const BpsPatch::InvalidPatch& unheadered_error) {
+				spdlog::debug("BPS patch {} can't be applied in memory: {}", bps_patch_path.string(), unheadered_error.what());
+				return {};
+			}
+		}
+
+		const auto clean{ std::span(clean_rom).subspan(clean_header_size) };
+		const auto patched{ std::span(patched_rom).subspan(headerSize(patched_rom.size())) };
+		const auto base_header_size{ headerSize(base.value().size()) };
+		const auto graphics{ std::span(base.value()).subspan(base_header_size) };
+		if (patched.size() < clean.size() || graphics.size() < clean.size()) {
+			return {};
+		}
+
+		std::vector<char> merged(base.value().begin(), base.value().begin() + base_header_size);
+		try {
+			const auto merged_body{ RomMerge::threeWay(clean, patched, graphics) };
+			merged.insert(merged.end(), merged_body.begin(), merged_body.end());
+		}
+		catch (const RomMerge::Conflict& e) {
+			spdlog::debug("BPS patch {} conflicts with the graphics import, importing graphics into the patched ROM instead: {}",
+				bps_patch_path.string(), e.what());
+			return {};
+		}
+
+		return merged;
+	}
+}
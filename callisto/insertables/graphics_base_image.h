@@ -0,0 +1,73 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+#include <optional>
+#include <span>
+#include <mutex>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+#include "../graphics_util.h"
+#include "../path_util.h"
+#include "../cache/hasher.h"
+#include "../cache/base_image_cache.h"
+#include "../rom/bps_patch.h"
+#include "../rom/rom_merge.h"
+#include "../configuration/configuration.h"
+
+namespace fs = std::filesystem;
+
+namespace callisto {
+	// The clean ROM with the project's (Ex)GFX imported, built once per build
+	// (or restored from BaseImageCache) and shared by all FlipsInsertables, so each of them doesn't have to
+	// import all graphics into its own patched ROM through Lunar Magic
+	//
+	// A FlipsInsertable's patched ROM is then this image with the changes its BPS patch makes to the clean ROM
+	// merged in, see RomMerge, if the patch and the graphics import changed the same byte to different values
+	// the merge fails and the FlipsInsertable imports the graphics itself like before
+	//
+	// BPS patches are made against the clean ROM, so the image must not contain anything else, like the initial patch
+	class GraphicsBaseImage {
+	public:
+		static constexpr uint32_t FORMAT_VERSION{ 2 };
+
+	protected:
+		static constexpr auto IMAGE_FILE_NAME{ "graphics_base.smc" };
+
+		const Configuration& config;
+		const std::shared_ptr<BaseImageCache> base_image_cache;
+
+		bool needs_gfx{ false };
+		bool needs_exgfx{ false };
+
+		std::mutex mutex{};
+		bool attempted{ false };
+		std::optional<std::vector<char>> image{};
+
+		static Hasher::Hash fingerprintFolder(const fs::path& folder);
+		static std::vector<char> readFile(const fs::path& path);
+		static size_t headerSize(size_t rom_size) {
+			return rom_size & 0x7FFF;
+		}
+
+		Hasher::Hash identify() const;
+		std::vector<char> build() const;
+
+	public:
+		GraphicsBaseImage(const Configuration& config, std::shared_ptr<BaseImageCache> base_image_cache = nullptr);
+
+		bool isNeeded() const {
+			return needs_gfx || needs_exgfx;
+		}
+
+		// The whole ROM file, built on first use, empty if it couldn't be built
+		const std::optional<std::vector<char>>& get();
+
+		// Empty if the patch doesn't apply to the clean ROM or conflicts with the graphics import
+		std::optional<std::vector<char>> applyPatch(const fs::path& clean_rom_path, const fs::path& bps_patch_path);
+	};
+}
@@ -1,11 +1,12 @@
 #include "initial_patch.h"
 
 namespace callisto {
-	InitialPatch::InitialPatch(const Configuration& config) 
+	InitialPatch::InitialPatch(const Configuration& config, std::shared_ptr<BaseImageCache> base_image_cache) 
 		: RomInsertable(config),
 		flips_path(registerConfigurationDependency(config.flips_path).getOrThrow()),
 		clean_rom_path(registerConfigurationDependency(config.clean_rom).getOrThrow()),
-		initial_patch_path(registerConfigurationDependency(config.initial_patch).getOrThrow())
+		initial_patch_path(registerConfigurationDependency(config.initial_patch).getOrThrow()),
+		base_image_cache(base_image_cache)
 	{
 
 	}
@@ -23,6 +24,21 @@ namespace callisto {
 	}
 
 	void InitialPatch::insert(const fs::path& target_rom) {
+		std::optional<std::pair<Hasher::Hash, Hasher::Hash>> base_image_key{};
+		if (base_image_cache != nullptr && fs::exists(clean_rom_path) && fs::exists(initial_patch_path)) {
+			base_image_key = { Hasher::hashFile(clean_rom_path), Hasher::hashFile(initial_patch_path) };
+			try {
+				if (base_image_cache->restore(base_image_key.value().first, base_image_key.value().second, target_rom)) {
+					spdlog::info(fmt::format(colors::RESOURCE, "Applying initial patch {}", initial_patch_path.string()));
+					spdlog::info(fmt::format(colors::PARTIAL_SUCCESS, "Applied initial patch from cache!"));
+					return;
+				}
+			}
+			catch (const std::exception& e) {
+				spdlog::debug("Failed to restore base image: {}", e.what());
+			}
+		}
+
 		if (!fs::exists(flips_path)) {
 			throw ToolNotFoundException(fmt::format(
 				colors::EXCEPTION,
@@ -68,5 +84,14 @@ namespace callisto {
 		else {
 			spdlog::info(fmt::format(colors::PARTIAL_SUCCESS, "Successfully applied initial patch!"));
 		}
+
+		if (base_image_key.has_value()) {
+			try {
+				base_image_cache->record(base_image_key.value().first, base_image_key.value().second, target_rom);
+			}
+			catch (const std::exception& e) {
+				spdlog::debug("Failed to cache base image: {}", e.what());
+			}
+		}
 	}
 }
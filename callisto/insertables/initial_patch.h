@@ -11,6 +11,7 @@
 #include "../insertion_exception.h"
 #include "../dependency/policy.h"
 #include "../dependency/resource_dependency.h"
+#include "../cache/base_image_cache.h"
 
 namespace bp = boost::process;
 namespace fs = std::filesystem;
@@ -21,11 +22,12 @@ namespace callisto {
 		const fs::path flips_path;
 		const fs::path clean_rom_path;
 		const fs::path initial_patch_path;
+		const std::shared_ptr<BaseImageCache> base_image_cache;
 
 		std::unordered_set<ResourceDependency> determineDependencies() override;
 
 	public:
-		InitialPatch(const Configuration& config);
+		InitialPatch(const Configuration& config, std::shared_ptr<BaseImageCache> base_image_cache = nullptr);
 
 		void insert() override;
 		void insert(const fs::path& target_rom);
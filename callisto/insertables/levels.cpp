@@ -1,8 +1,9 @@
 #include "levels.h"
 
 namespace callisto {
-	Levels::Levels(const Configuration& config)
-		: LunarMagicInsertable(config), 
+	Levels::Levels(const Configuration& config, std::shared_ptr<RomImage> rom_image,
+		std::shared_ptr<StepCache> step_cache)
+		: LunarMagicInsertable(config, rom_image, step_cache), 
 		levels_folder(registerConfigurationDependency(config.levels, Policy::REINSERT).getOrThrow())
 	{
 		registerConfigurationDependency(config.level_import_flag);
@@ -321,7 +322,7 @@ namespace callisto {
 		return dependencies;
 	}
 
-	void Levels::insert() {
+	void Levels::insertIntoRomFile() {
 		checkLunarMagicExists();
 
 		if (!fs::exists(levels_folder)) {
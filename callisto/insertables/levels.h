@@ -31,13 +31,13 @@ namespace callisto {
 		static void setInternalLevelNumber(const fs::path& mwl_path, int level_number);
 
 		std::unordered_set<ResourceDependency> determineDependencies() override;
+		void insertIntoRomFile() override;
 
 	public:
 		static std::optional<int> getInternalLevelNumber(const fs::path& mwl_path);
 		static void normalizeMwls(const fs::path& levels_folder_path, bool allow_user_input);
 
-		void insert() override;
-
-		Levels(const Configuration& config);
+		Levels(const Configuration& config, std::shared_ptr<RomImage> rom_image = nullptr,
+			std::shared_ptr<StepCache> step_cache = nullptr);
 	};
 }
@@ -1,9 +1,11 @@
 #include "lunar_magic_insertable.h"
 
 namespace callisto {
-	LunarMagicInsertable::LunarMagicInsertable(const Configuration& config)
-		: RomInsertable(config), 
-		lunar_magic_path(registerConfigurationDependency(config.lunar_magic_path, Policy::REINSERT).getOrThrow()) {
+	LunarMagicInsertable::LunarMagicInsertable(const Configuration& config, std::shared_ptr<RomImage> rom_image,
+		std::shared_ptr<StepCache> step_cache)
+		: RomInsertable(config, rom_image), 
+		lunar_magic_path(registerConfigurationDependency(config.lunar_magic_path, Policy::REINSERT).getOrThrow()),
+		step_cache(step_cache) {
 	}
 
 	std::unordered_set<ResourceDependency> LunarMagicInsertable::determineDependencies() {
@@ -19,4 +21,55 @@ namespace callisto {
 			));
 		}
 	}
+
+	StepCache::Inputs LunarMagicInsertable::getCacheInputs() {
+		StepCache::Inputs inputs{ { "lunar_magic" }, { lunar_magic_path }, std::nullopt, {}, std::nullopt };
+
+		// the registered settings tell the steps apart and cover flags like the level import flag
+		for (const auto& dependency : configuration_dependencies) {
+			std::string value{};
+			if (std::holds_alternative<std::string>(dependency.value)) {
+				value = std::get<std::string>(dependency.value);
+			}
+			else if (std::holds_alternative<bool>(dependency.value)) {
+				value = std::get<bool>(dependency.value) ? "true" : "false";
+			}
+			else if (std::holds_alternative<std::vector<fs::path>>(dependency.value)) {
+				for (const auto& path : std::get<std::vector<fs::path>>(dependency.value)) {
+					value += path.string() + ';';
+				}
+			}
+			inputs.settings.push_back(fmt::format("{}={}", dependency.config_keys, value));
+		}
+
+		for (const auto& dependency : determineDependencies()) {
+			inputs.files.push_back(dependency.dependent_path);
+		}
+
+		return inputs;
+	}
+
+	void LunarMagicInsertable::insert() {
+		if (rom_image == nullptr) {
+			insertIntoRomFile();
+			return;
+		}
+
+		if (step_cache != nullptr) {
+			const auto result{ step_cache->lookup(getCacheInputs(), rom_image->getBody()) };
+			if (result.has_value()) {
+				rom_image->applyDelta(result.value().delta);
+				spdlog::info(fmt::format(colors::PARTIAL_SUCCESS, "Applied Lunar Magic result from cache!"));
+				return;
+			}
+		}
+
+		rom_image->flush();
+		insertIntoRomFile();
+		rom_image->reload();
+
+		if (step_cache != nullptr) {
+			step_cache->record(rom_image->getBody());
+		}
+	}
 }
@@ -10,6 +10,7 @@
 #include "../insertable.h"
 #include "../not_found_exception.h"
 #include "rom_insertable.h"
+#include "../cache/step_cache.h"
 
 #include "../configuration/configuration.h"
 #include "../dependency/policy.h"
@@ -21,8 +22,10 @@ namespace callisto {
 	class LunarMagicInsertable : public RomInsertable {
 	protected:
 		const fs::path lunar_magic_path;
+		const std::shared_ptr<StepCache> step_cache;
 
-		LunarMagicInsertable(const Configuration& config);
+		LunarMagicInsertable(const Configuration& config, std::shared_ptr<RomImage> rom_image = nullptr,
+			std::shared_ptr<StepCache> step_cache = nullptr);
 
 		template<typename... Args>
 		int callLunarMagic(Args... args) {
@@ -32,5 +35,16 @@ namespace callisto {
 		std::unordered_set<ResourceDependency> determineDependencies() override;
 
 		void checkLunarMagicExists();
+
+		// Calls Lunar Magic on the temporary ROM file
+		virtual void insertIntoRomFile() = 0;
+
+		// Everything besides the ROM that determines what insertIntoRomFile does to it
+		virtual StepCache::Inputs getCacheInputs();
+
+	public:
+		// With a ROM image, the file is synced around the call and, given a step cache, the call
+		// is skipped entirely if the cache knows what it did to the same ROM last time
+		void insert() override;
 	};
 }
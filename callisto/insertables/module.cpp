@@ -2,12 +2,14 @@
 
 namespace callisto {
 	Module::Module(const Configuration& config,
+		std::shared_ptr<RomImage> rom_image,
+		std::shared_ptr<AsarCache> asar_cache,
 		const fs::path& input_path,
 		const fs::path& callisto_asm_file,
 		std::shared_ptr<std::unordered_set<int>> current_module_addresses,
 		int id,
 		const std::vector<fs::path>& additional_include_paths) :
-		RomInsertable(config), 
+		RomInsertable(config, rom_image, asar_cache), 
 		input_path(input_path),
 		output_paths(config.module_configurations.at(input_path).real_output_paths.getOrThrow()),
 		project_relative_path(fs::relative(input_path, registerConfigurationDependency(config.project_root).getOrThrow())),
@@ -78,16 +80,12 @@ namespace callisto {
 		patch.buffer = patch_string.c_str();
 		patch.length = patch_string.size();
 
-		const auto rom_size{ fs::file_size(temporary_rom_path) };
-		const auto header_size{ (int)rom_size & 0x7FFF };
-		int unheadered_rom_size{ (int)rom_size - header_size };
+		rom_writes.reset();
 
-		std::vector<char> rom_bytes(MAX_ROM_SIZE);
-		std::vector<char> header(header_size);
-		std::ifstream rom_file(temporary_rom_path, std::ios::binary);
-		rom_file.read(reinterpret_cast<char*>(header.data()), header_size);
-		rom_file.read(reinterpret_cast<char*>(rom_bytes.data()), unheadered_rom_size);
-		rom_file.close();
+		const auto header_size{ rom_image->getHeader().size() };
+		int unheadered_rom_size{ static_cast<int>(rom_image->getSize()) };
+		const auto rom_size_before{ unheadered_rom_size };
+		const auto rom_data{ rom_image->beginPatching() };
 
 		spdlog::debug(fmt::format(
 			"Applying module {} to temporary ROM {}:\n\r"
@@ -95,7 +93,7 @@ namespace callisto {
 			"\tROM header size:\t\t{}\n\r",
 			input_path.string(),
 			temporary_rom_path.string(),
-			rom_size,
+			unheadered_rom_size + header_size,
 			header_size
 		));
 
@@ -108,6 +106,35 @@ namespace callisto {
 			"1"
 		};
 
+		std::vector<fs::path> implicit_dependencies{ input_path };
+		if (module_header_file.has_value()) {
+			implicit_dependencies.push_back(module_header_file.value());
+		}
+
+		const AsarCache::Invocation invocation{
+			patch_string,
+			additional_include_paths,
+			{ { callisto_define.name, callisto_define.contents } },
+			implicit_dependencies,
+			temporary_rom_path.parent_path() / ".dependencies"
+		};
+
+		if (asar_cache != nullptr) {
+			const auto cached{ asar_cache->lookup(invocation, { rom_data, static_cast<size_t>(unheadered_rom_size) }) };
+			if (cached.has_value()) {
+				unheadered_rom_size = replayAsarResult(invocation, cached.value(), rom_data, rom_size_before);
+				rom_image->finishPatching(unheadered_rom_size, true);
+				labels = cached.value().labels;
+
+				recordOurAddresses();
+				spdlog::info(fmt::format(colors::PARTIAL_SUCCESS, "Successfully applied module {} from cache!", project_relative_path.string()));
+				finishInsertion();
+
+				fs::current_path(prev_folder);
+				return;
+			}
+		}
+
 		std::vector<const char*> as_c_strs{};
 		for (const auto& path : additional_include_paths) {
 			auto c_str{ new char[path.string().size() + 1] };
@@ -118,8 +145,8 @@ namespace callisto {
 		const patchparams params{
 			sizeof(struct patchparams),
 			"temp.asm",
-			rom_bytes.data(),
-			MAX_ROM_SIZE,
+			rom_data,
+			AssemblyBufferPool::BUFFER_SIZE,
 			&unheadered_rom_size,
 			reinterpret_cast<const char**>(as_c_strs.data()),
 			static_cast<int>(as_c_strs.size()),
@@ -143,6 +170,7 @@ namespace callisto {
 			));
 		}
 
+		prepareAsarWrites(rom_data, unheadered_rom_size);
 		asar_reset();
 		const bool succeeded{ asar_patch_ex(&params) };
 
@@ -159,6 +187,8 @@ namespace callisto {
 		}
 
 		if (succeeded) {
+			rom_image->finishPatching(unheadered_rom_size, true);
+
 			int warning_count;
 			const auto warnings{ asar_getwarnings(&warning_count) };
 			bool missing_org_or_freespace{ false };
@@ -177,25 +207,25 @@ namespace callisto {
 				));
 			}
 
+			labels = AsarCache::getAsarLabels();
 			recordOurAddresses();
 			verifyNonHijacking();
 			
-			verifyWrittenBlockCoverage(rom_bytes);
+			verifyWrittenBlockCoverage({ rom_data, static_cast<size_t>(unheadered_rom_size) });
 
-			std::ofstream out_rom{ temporary_rom_path, std::ios::out | std::ios::binary };
-			out_rom.write(header.data(), header_size);
-			out_rom.write(rom_bytes.data(), unheadered_rom_size);
-			out_rom.close();
+			recordAsarWrites(params.romdata, rom_size_before, unheadered_rom_size);
+			if (asar_cache != nullptr) {
+				asar_cache->record(invocation, { rom_data, static_cast<size_t>(unheadered_rom_size) });
+			}
 			spdlog::info(fmt::format(colors::PARTIAL_SUCCESS, "Successfully applied module {}!", project_relative_path.string()));
 
-			emitOutputFiles();
-			emitPlainAddressFile();
-
-			current_module_addresses->insert(our_module_addresses.begin(), our_module_addresses.end());
+			finishInsertion();
 
 			fs::current_path(prev_folder);
 		}
 		else {
+			rom_image->finishPatching(rom_size_before, false);
+
 			int error_count;
 			const auto errors{ asar_geterrors(&error_count) };
 			std::ostringstream error_string{};
@@ -217,6 +247,13 @@ namespace callisto {
 		}
 	}
 
+	void Module::finishInsertion() {
+		emitOutputFiles();
+		emitPlainAddressFile();
+
+		current_module_addresses->insert(our_module_addresses.begin(), our_module_addresses.end());
+	}
+
 	std::string Module::modulePathToName(const fs::path& path) {
 		auto prefix{ path.stem().string() };
 		std::replace(prefix.begin(), prefix.end(), ' ', '_');
@@ -238,8 +275,7 @@ namespace callisto {
 
 		real_output_file << fmt::format("incsrc \"{}\"\n\n", PathUtil::sanitizeForAsar(PathUtil::convertToPosixPath(callisto_asm_file)).string());
 
-		int label_number{};
-		const auto labels{ asar_getalllabels(&label_number) };
+		const auto label_number{ static_cast<int>(labels.size()) };
 
 		const auto module_name{ modulePathToName(output_path) };
 
@@ -327,12 +363,8 @@ namespace callisto {
 	}
 
 	void Module::recordOurAddresses() {
-		int label_count{};
-		const auto labels{ asar_getalllabels(&label_count) };
-
-		for (int i{ 0 }; i != label_count; ++i) {
-			const auto& label{ labels[i] };
-			const auto name{ std::string(label.name) };
+		for (const auto& label : labels) {
+			const auto& name{ label.name };
 
 			if (name.at(0) == ':') {
 				// it's a relative label (+, -, ++, ...), skip it
@@ -353,10 +385,7 @@ namespace callisto {
 		}
 	}
 
-	void Module::verifyWrittenBlockCoverage(const std::vector<char>& rom) const {
-		int label_count{};
-		const auto labels{ asar_getalllabels(&label_count) };
-
+	void Module::verifyWrittenBlockCoverage(std::span<const char> rom) const {
 		int block_count{};
 		const auto written_blocks{ asar_getwrittenblocks(&block_count) };
 		const auto as_structs{ convertToWrittenBlockVector(written_blocks, block_count) };
@@ -364,11 +393,11 @@ namespace callisto {
 		for (const auto& freespace_area : freespace_areas) {
 			bool is_covered{ false };
 			for (const auto& written_block : freespace_area) {
-				for (int j{ 0 }; j != label_count; ++j) {
+				for (const auto& label : labels) {
 					// uggo but labels can have the bank byte be | $80 or not depending on how the user does things I think?
 					// not sure how this affects sa1 ROMs but I'm guessing it's a niche issue if anything (hopefully not wrong)
-					const auto location_low{ labels[j].location };
-					const auto location_high{ labels[j].location | 0x800000 };
+					const auto location_low{ label.location };
+					const auto location_high{ label.location | 0x800000 };
 					if ((location_low >= written_block.start_snes && location_low < written_block.end_snes) 
 						|| (location_high >= written_block.start_snes && location_high < written_block.end_snes)) {
 						is_covered = true;
@@ -381,7 +410,7 @@ namespace callisto {
 			}
 
 			if (!is_covered) {
-				auto freespace_start{ freespace_area.front().start_snes + RATS_TAG_SIZE };
+				auto freespace_start{ freespace_area.front().start_snes + Rats::TAG_SIZE };
 				if ((freespace_start & 0xFFFF) < 0x8000) {
 					freespace_start += 0x8000;
 				}
@@ -389,7 +418,7 @@ namespace callisto {
 				const auto freespace_size{ std::accumulate(freespace_area.begin(), freespace_area.end(), 0, 
 					[](int val1, const WrittenBlock& val2) {
 					return val1 + val2.size;
-				}) - RATS_TAG_SIZE };
+				}) - Rats::TAG_SIZE };
 
 				throw InsertionException(fmt::format(
 					colors::EXCEPTION,
@@ -402,25 +431,6 @@ namespace callisto {
 		}
 	}
 
-	std::optional<uint16_t> Module::determineFreespaceBlockSize(size_t pc_address, const std::vector<char>& rom) {
-		char potential_tag[5];
-		strncpy(potential_tag, rom.data() + pc_address, 4);
-		potential_tag[4] = '\0';
-
-		if (std::string(potential_tag) != std::string(RATS_TAG_TEXT)) {
-			return {};
-		}
-
-		const auto potential_size{ (((unsigned char)rom[pc_address + 5]) << 8) | ((unsigned char)rom[pc_address + 4]) };
-		const auto potential_size_complement{ (((unsigned char)rom[pc_address + 7]) << 8) | ((unsigned char)rom[pc_address + 6]) };
-
-		if (potential_size + 1 != (potential_size_complement ^ 0xFFFF) + 1) {
-			return {};
-		}
-
-		return potential_size + 1;
-	}
-
 	std::vector<Module::WrittenBlock> Module::convertToWrittenBlockVector(const writtenblockdata* const written_blocks, int block_count) {
 		std::vector<WrittenBlock> written_block_vec{};
 		for (int i{ 0 }; i != block_count; ++i) {
@@ -438,7 +448,7 @@ namespace callisto {
 		return written_block_vec;
 	}
 
-	std::vector<Module::FreespaceArea> Module::convertToFreespaceAreas(const std::vector<WrittenBlock>& written_blocks, const std::vector<char>& rom) {
+	std::vector<Module::FreespaceArea> Module::convertToFreespaceAreas(const std::vector<WrittenBlock>& written_blocks, std::span<const char> rom) {
 		std::vector<FreespaceArea> freespace_areas{};
 
 		auto curr_block{ written_blocks.begin() };
@@ -454,11 +464,11 @@ namespace callisto {
 			while (size_left_in_curr_block != 0) {
 				if (curr_freespace_size_left == 0) {
 					freespace_areas.push_back(std::vector<WrittenBlock>());
-					const auto freespace_size{ determineFreespaceBlockSize(curr_pc_offset, rom) };
+					const auto freespace_size{ Rats::blockSize(rom, curr_pc_offset) };
 					if (!freespace_size.has_value()) {
 						throw InsertionException(fmt::format(colors::EXCEPTION, "Freespace area at ${:06X} has invalid/no RATS tag", curr_pc_offset));
 					}
-					curr_freespace_size_left = freespace_size.value() + RATS_TAG_SIZE;
+					curr_freespace_size_left = freespace_size.value() + Rats::TAG_SIZE;
 				}
 
 				const auto served_by_block{ std::min(size_left_in_curr_block, curr_freespace_size_left) };
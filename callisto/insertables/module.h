@@ -6,6 +6,7 @@
 #include <iterator>
 #include <unordered_set>
 #include <optional>
+#include <span>
 
 #include <fmt/core.h>
 #include <spdlog/spdlog.h>
@@ -19,6 +20,7 @@
 
 #include "../configuration/configuration.h"
 #include "../dependency/policy.h"
+#include "../rom/rats.h"
 
 namespace fs = std::filesystem;
 
@@ -26,9 +28,6 @@ namespace callisto {
 	class Module : public RomInsertable {
 	protected:
 		static constexpr auto PLACEHOLDER_LABEL{ "PLACEHOLDER " };
-		static constexpr auto MAX_ROM_SIZE{ 16 * 1024 * 1024 };
-		static constexpr auto RATS_TAG_TEXT{ "STAR" };
-		static constexpr auto RATS_TAG_SIZE{ 8 };
 
 		struct WrittenBlock {
 			WrittenBlock(size_t start_pc, size_t start_snes, size_t size)
@@ -49,6 +48,7 @@ namespace callisto {
 
 		std::shared_ptr<std::unordered_set<int>> current_module_addresses;
 		std::unordered_set<int> our_module_addresses{};
+		std::vector<AsarCache::Label> labels{};
 
 		const fs::path input_path;
 		const std::vector<fs::path> output_paths;
@@ -66,18 +66,18 @@ namespace callisto {
 		void emitOutputFiles() const;
 		void emitOutputFile(const fs::path& output_path) const;
 		void emitPlainAddressFile() const;
+		void finishInsertion();
 
 		std::unordered_set<ResourceDependency> determineDependencies() override;
 
 		void fixAsarMemoryLeak() const;
 
 		void recordOurAddresses();
-		void verifyWrittenBlockCoverage(const std::vector<char>& rom) const;
+		void verifyWrittenBlockCoverage(std::span<const char> rom) const;
 		void verifyNonHijacking() const;
 
-		static std::optional<uint16_t> determineFreespaceBlockSize(size_t pc_address, const std::vector<char>& rom);
 		static std::vector<WrittenBlock> convertToWrittenBlockVector(const writtenblockdata* const written_blocks, int block_count);
-		static std::vector<FreespaceArea> convertToFreespaceAreas(const std::vector<WrittenBlock>& written_blocks, const std::vector<char>& rom);
+		static std::vector<FreespaceArea> convertToFreespaceAreas(const std::vector<WrittenBlock>& written_blocks, std::span<const char> rom);
 
 	public:
 		static std::string modulePathToName(const fs::path& path);
@@ -87,6 +87,8 @@ namespace callisto {
 		};
 
 		Module(const Configuration& config,
+			std::shared_ptr<RomImage> rom_image,
+			std::shared_ptr<AsarCache> asar_cache,
 			const fs::path& input_path,
 			const fs::path& callisto_asm_file,
 			std::shared_ptr<std::unordered_set<int>> current_module_addresses,
@@ -26,8 +26,9 @@ namespace callisto {
 		}
 
 	public:
-		Overworld(const Configuration& config)
-			: FlipsInsertable(config, config.overworld)
+		Overworld(const Configuration& config, std::shared_ptr<RomImage> rom_image = nullptr,
+			std::shared_ptr<StepCache> step_cache = nullptr, std::shared_ptr<GraphicsBaseImage> graphics_base_image = nullptr)
+			: FlipsInsertable(config, config.overworld, rom_image, step_cache, graphics_base_image)
 		{
 			checkPatchExists();
 		}
@@ -1,9 +1,9 @@
 #include "patch.h"
 
 namespace callisto {
-	Patch::Patch(const Configuration& config, const fs::path& patch_path,
-		const std::vector<fs::path>& additional_include_paths)
-		: RomInsertable(config), 
+	Patch::Patch(const Configuration& config, std::shared_ptr<RomImage> rom_image, std::shared_ptr<AsarCache> asar_cache,
+		const fs::path& patch_path, const std::vector<fs::path>& additional_include_paths)
+		: RomInsertable(config, rom_image, asar_cache), 
 		project_relative_path(fs::relative(patch_path, registerConfigurationDependency(config.project_root).getOrThrow())),
 		patch_path(patch_path),
 		additional_include_paths(additional_include_paths)
@@ -37,16 +37,12 @@ namespace callisto {
 
 		const auto str_patch_path{ patch_path.string() };
 
-		const auto rom_size{ fs::file_size(temporary_rom_path) };
-		const auto header_size{ (int)rom_size & 0x7FFF };
-		int unheadered_rom_size{ (int)rom_size - header_size };
+		rom_writes.reset();
 
-		std::vector<char> rom_bytes(MAX_ROM_SIZE);
-		std::vector<char> header(header_size);
-		std::ifstream rom_file(temporary_rom_path, std::ios::binary);
-		rom_file.read(reinterpret_cast<char*>(header.data()), header_size);
-		rom_file.read(reinterpret_cast<char*>(rom_bytes.data()), unheadered_rom_size);
-		rom_file.close();
+		const auto header_size{ rom_image->getHeader().size() };
+		int unheadered_rom_size{ static_cast<int>(rom_image->getSize()) };
+		const auto rom_size_before{ unheadered_rom_size };
+		const auto rom_data{ rom_image->beginPatching() };
 
 		spdlog::debug(fmt::format(
 			"Applying patch {} to temporary ROM {}:\n\r"
@@ -54,7 +50,7 @@ namespace callisto {
 			"\tROM header size:\t\t{}\n\r",
 			patch_path.string(),
 			temporary_rom_path.string(),
-			rom_size,
+			unheadered_rom_size + header_size,
 			header_size
 		));
 
@@ -63,6 +59,27 @@ namespace callisto {
 			"1"
 		};
 
+		const AsarCache::Invocation invocation{
+			str_patch_path,
+			additional_include_paths,
+			{ { callisto_define.name, callisto_define.contents } },
+			{ patch_path },
+			patch_path.parent_path() / ".dependencies"
+		};
+
+		if (asar_cache != nullptr) {
+			const auto cached{ asar_cache->lookup(invocation, { rom_data, static_cast<size_t>(unheadered_rom_size) }) };
+			if (cached.has_value()) {
+				unheadered_rom_size = replayAsarResult(invocation, cached.value(), rom_data, rom_size_before);
+				recordHijacks(cached.value().written_blocks);
+				rom_image->finishPatching(unheadered_rom_size, true);
+				fs::current_path(prev_folder);
+
+				spdlog::info(fmt::format(colors::PARTIAL_SUCCESS, "Successfully applied patch {} from cache!", project_relative_path.string()));
+				return;
+			}
+		}
+
 		warnsetting disable_relative_path_warning;
 		disable_relative_path_warning.warnid = "1001";
 		disable_relative_path_warning.enabled = false;
@@ -77,8 +94,8 @@ namespace callisto {
 		const patchparams params{
 			sizeof(struct patchparams),
 			str_patch_path.c_str(),
-			rom_bytes.data() + header_size,
-			MAX_ROM_SIZE,
+			rom_data,
+			AssemblyBufferPool::BUFFER_SIZE,
 			&unheadered_rom_size,
 			reinterpret_cast<const char**>(as_c_strs.data()),
 			static_cast<int>(as_c_strs.size()),
@@ -102,6 +119,7 @@ namespace callisto {
 			));
 		}
 
+		prepareAsarWrites(rom_data, unheadered_rom_size);
 		const bool succeeded{ asar_patch_ex(&params) };
 
 		for (auto c_str : as_c_strs) {
@@ -124,24 +142,27 @@ namespace callisto {
 			for (int i = 0; i != warning_count; ++i) {
 				spdlog::warn(warnings[i].fullerrdata);
 			}
-			std::ofstream out_rom{ temporary_rom_path, std::ios::out | std::ios::binary };
-			out_rom.write(header.data(), header_size);
-			out_rom.write(rom_bytes.data(), unheadered_rom_size);
-			out_rom.close();
 
 			int written_block_count;
 			const auto written_blocks{ asar_getwrittenblocks(&written_block_count) };
 
+			std::vector<std::pair<size_t, size_t>> blocks{};
 			for (size_t i{ 0 }; i != written_block_count; ++i) {
-				const auto& block{ written_blocks[i] };
-				if (block.pcoffset < 0x80000) {
-					hijacks.push_back({ block.pcoffset, block.numbytes });
-				}
+				blocks.push_back({ written_blocks[i].pcoffset, written_blocks[i].numbytes });
 			}
+			recordHijacks(blocks);
+
+			recordAsarWrites(params.romdata, rom_size_before, unheadered_rom_size);
+			if (asar_cache != nullptr) {
+				asar_cache->record(invocation, { rom_data, static_cast<size_t>(unheadered_rom_size) });
+			}
+			rom_image->finishPatching(unheadered_rom_size, true);
 
 			spdlog::info(fmt::format(colors::PARTIAL_SUCCESS, "Successfully applied patch {}!", project_relative_path.string()));
 		}
 		else {
+			rom_image->finishPatching(rom_size_before, false);
+
 			int error_count;
 			const auto errors{ asar_geterrors(&error_count) };
 			std::ostringstream error_string{};
@@ -162,6 +183,14 @@ namespace callisto {
 		}
 	}
 
+	void Patch::recordHijacks(const std::vector<std::pair<size_t, size_t>>& written_blocks) {
+		for (const auto& [pc_offset, size] : written_blocks) {
+			if (pc_offset < 0x80000) {
+				hijacks.push_back({ pc_offset, size });
+			}
+		}
+	}
+
 	const std::vector<std::pair<size_t, size_t>>& Patch::getHijacks() const {
 		return hijacks;
 	}
@@ -22,8 +22,6 @@ namespace fs = std::filesystem;
 namespace callisto {
 	class Patch : public RomInsertable {
 	protected:
-		static constexpr auto MAX_ROM_SIZE = 16 * 1024 * 1024;
-
 		const fs::path patch_path;
 		std::vector<fs::path> additional_include_paths;
 		std::vector<std::pair<size_t, size_t>> hijacks{};
@@ -31,13 +29,14 @@ namespace callisto {
 		std::unordered_set<ResourceDependency> determineDependencies() override;
 
 		void fixAsarMemoryLeak() const;
+		void recordHijacks(const std::vector<std::pair<size_t, size_t>>& written_blocks);
 
 	public:
 		const fs::path project_relative_path;
 
 		const std::vector<std::pair<size_t, size_t>>& getHijacks() const;
 
-		Patch(const Configuration& config,
+		Patch(const Configuration& config, std::shared_ptr<RomImage> rom_image, std::shared_ptr<AsarCache> asar_cache,
 			const fs::path& patch_path, const std::vector<fs::path>& additional_include_paths = {});
 
 		void insert() override;
@@ -2,11 +2,21 @@
 
 #include <string>
 #include <filesystem>
+#include <vector>
+#include <optional>
+#include <utility>
+#include <memory>
+#include <algorithm>
 
 #include <fmt/format.h>
+#include <spdlog/spdlog.h>
+#include <asar-dll-bindings/c/asardll.h>
 
 #include "../insertable.h"
 #include "../not_found_exception.h"
+#include "../rom/rom_image.h"
+#include "../cache/asar_cache.h"
+#include "../cache/hasher.h"
 
 #include "../configuration/configuration.h"
 
@@ -16,10 +26,118 @@ namespace callisto {
 	class RomInsertable : public Insertable {
 	protected:
 		const fs::path temporary_rom_path;
+		const std::shared_ptr<RomImage> rom_image;
+		const std::shared_ptr<AsarCache> asar_cache;
 
-		RomInsertable(const Configuration& config) 
+		// asar doesn't report everything it changes (autoclean and RATS tags being freed, for one), so the ROM is
+		// hashed in chunks before patching and changed chunks the reported blocks don't cover are handed over whole
+		static constexpr size_t VERIFICATION_CHUNK_SIZE{ 0x1000 };
+
+		bool track_rom_writes{ false };
+		std::vector<Hasher::Hash> chunk_hashes_before{};
+		std::optional<std::vector<RomWrite>> rom_writes{};
+
+		// Call right before handing rom_data to asar
+		void prepareAsarWrites(const char* rom_data, int rom_size) {
+			rom_writes.reset();
+			chunk_hashes_before.clear();
+			if (!track_rom_writes) {
+				return;
+			}
+
+			const auto size{ static_cast<size_t>(rom_size) };
+			chunk_hashes_before.reserve((size + VERIFICATION_CHUNK_SIZE - 1) / VERIFICATION_CHUNK_SIZE);
+			for (size_t offset{ 0 }; offset < size; offset += VERIFICATION_CHUNK_SIZE) {
+				chunk_hashes_before.push_back(Hasher::hash({ rom_data + offset, std::min(VERIFICATION_CHUNK_SIZE, size - offset) }));
+			}
+		}
+
+		// rom_data is the buffer that was passed to asar, only call after a successful patch
+		void recordAsarWrites(const char* rom_data, int rom_size_before, int rom_size_after) {
+			// expanding the ROM also touches bytes asar doesn't report, so leave that case to a full diff
+			if (chunk_hashes_before.empty() || rom_size_before != rom_size_after) {
+				rom_writes.reset();
+				return;
+			}
+
+			int block_count{};
+			const auto written_blocks{ asar_getwrittenblocks(&block_count) };
+
+			std::vector<std::pair<size_t, size_t>> blocks{};
+			blocks.reserve(block_count);
+			for (int i{ 0 }; i != block_count; ++i) {
+				blocks.push_back({ static_cast<size_t>(written_blocks[i].pcoffset), static_cast<size_t>(written_blocks[i].numbytes) });
+			}
+			std::sort(blocks.begin(), blocks.end());
+
+			rom_writes = std::vector<RomWrite>();
+			rom_writes.value().reserve(blocks.size());
+			for (const auto& [pc_offset, size] : blocks) {
+				const auto start{ rom_data + pc_offset };
+				rom_writes.value().push_back({ pc_offset, std::vector<char>(start, start + size) });
+			}
+
+			// merged [start, end) ranges of the blocks, to tell which chunks they cover completely
+			std::vector<std::pair<size_t, size_t>> covered{};
+			for (const auto& [pc_offset, size] : blocks) {
+				if (!covered.empty() && pc_offset <= covered.back().second) {
+					covered.back().second = std::max(covered.back().second, pc_offset + size);
+				}
+				else {
+					covered.push_back({ pc_offset, pc_offset + size });
+				}
+			}
+
+			const auto rom_size{ static_cast<size_t>(rom_size_after) };
+			auto range{ covered.begin() };
+			for (size_t chunk{ 0 }; chunk != chunk_hashes_before.size(); ++chunk) {
+				const auto chunk_start{ chunk * VERIFICATION_CHUNK_SIZE };
+				const auto chunk_end{ std::min(chunk_start + VERIFICATION_CHUNK_SIZE, rom_size) };
+
+				while (range != covered.end() && range->second <= chunk_start) {
+					++range;
+				}
+				if (range != covered.end() && range->first <= chunk_start && range->second >= chunk_end) {
+					continue;
+				}
+
+				if (Hasher::hash({ rom_data + chunk_start, chunk_end - chunk_start }) != chunk_hashes_before[chunk]) {
+					rom_writes.value().push_back({ chunk_start, std::vector<char>(rom_data + chunk_start, rom_data + chunk_end) });
+				}
+			}
+			chunk_hashes_before.clear();
+		}
+
+		// Does to rom_data what asar did when the result was recorded, returns the resulting ROM size
+		int replayAsarResult(const AsarCache::Invocation& invocation, const AsarCache::Result& result, char* rom_data, int rom_size_before) {
+			result.delta.applyTo({ rom_data, AssemblyBufferPool::BUFFER_SIZE });
+			const auto rom_size_after{ static_cast<int>(result.delta.getSizeAfter()) };
+
+			for (const auto& print : result.prints) {
+				spdlog::info(print);
+			}
+			for (const auto& warning : result.warnings) {
+				spdlog::warn(fmt::format(colors::WARNING, "{}", warning.message));
+			}
+
+			asar_cache->restoreDependencyReport(invocation, result);
+
+			// unlike the written blocks, the delta holds everything the patch changed
+			rom_writes.reset();
+			if (track_rom_writes && rom_size_before == rom_size_after) {
+				rom_writes = std::vector<RomWrite>();
+				rom_writes.value().reserve(result.delta.getChanges().size());
+				for (const auto& change : result.delta.getChanges()) {
+					rom_writes.value().push_back({ change.pc_offset, change.bytes });
+				}
+			}
+			return rom_size_after;
+		}
+
+		RomInsertable(const Configuration& config, std::shared_ptr<RomImage> rom_image = nullptr,
+			std::shared_ptr<AsarCache> asar_cache = nullptr) 
 			: temporary_rom_path(PathUtil::getTemporaryRomPath(config.temporary_folder.getOrThrow(),
-				config.output_rom.getOrThrow())) {
+				config.output_rom.getOrThrow())), rom_image(rom_image), asar_cache(asar_cache) {
 			if (!fs::exists(temporary_rom_path)) {
 				throw RomNotFoundException(fmt::format(
 					"Temporary ROM not found at {}",
@@ -27,5 +145,18 @@ namespace callisto {
 				));
 			}
 		}
+
+	public:
+		void trackRomWrites() override {
+			track_rom_writes = true;
+		}
+
+		std::optional<std::vector<RomWrite>> takeRomWrites() override {
+			return std::exchange(rom_writes, std::nullopt);
+		}
+
+		bool usesRomImage() const override {
+			return rom_image != nullptr;
+		}
 	};
 }
@@ -1,8 +1,9 @@
 #include "shared_palettes.h"
 
 namespace callisto {
-	SharedPalettes::SharedPalettes(const Configuration& config)
-		: LunarMagicInsertable(config), 
+	SharedPalettes::SharedPalettes(const Configuration& config, std::shared_ptr<RomImage> rom_image,
+		std::shared_ptr<StepCache> step_cache)
+		: LunarMagicInsertable(config, rom_image, step_cache), 
 		shared_palettes_path(registerConfigurationDependency(config.shared_palettes, Policy::REINSERT).getOrThrow())
 	{
 
@@ -14,7 +15,7 @@ namespace callisto {
 		return dependencies;
 	}
 
-	void SharedPalettes::insert() {
+	void SharedPalettes::insertIntoRomFile() {
 		if (!fs::exists(shared_palettes_path)) {
 			throw ResourceNotFoundException(fmt::format(
 				colors::EXCEPTION,
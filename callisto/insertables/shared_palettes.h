@@ -20,10 +20,10 @@ namespace callisto {
 		const fs::path shared_palettes_path;
 
 		std::unordered_set<ResourceDependency> determineDependencies() override;
+		void insertIntoRomFile() override;
 
 	public:
-		void insert() override;
-
-		SharedPalettes(const Configuration& config);
+		SharedPalettes(const Configuration& config, std::shared_ptr<RomImage> rom_image = nullptr,
+			std::shared_ptr<StepCache> step_cache = nullptr);
 	};
 }
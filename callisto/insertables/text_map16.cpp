@@ -1,8 +1,9 @@
 #include "text_map16.h"
 
 namespace callisto {
-	TextMap16::TextMap16(const Configuration& config)
-		: LunarMagicInsertable(config), map16_folder_path(config.map16.getOrThrow())
+	TextMap16::TextMap16(const Configuration& config, std::shared_ptr<RomImage> rom_image,
+		std::shared_ptr<StepCache> step_cache)
+		: LunarMagicInsertable(config, rom_image, step_cache), map16_folder_path(config.map16.getOrThrow())
 	{
 		registerConfigurationDependency(config.map16, Policy::REINSERT);
 		registerConfigurationDependency(config.use_text_map16_format, Policy::REINSERT);
@@ -60,7 +61,7 @@ namespace callisto {
 		return dependencies;
 	}
 
-	void TextMap16::insert() {
+	void TextMap16::insertIntoRomFile() {
 		if (!fs::exists(map16_folder_path)) {
 			throw ResourceNotFoundException(fmt::format(
 				colors::EXCEPTION,
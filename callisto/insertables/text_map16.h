@@ -28,10 +28,10 @@ namespace callisto {
 		void deleteTemporaryMap16File() const;
 
 		std::unordered_set<ResourceDependency> determineDependencies() override;
+		void insertIntoRomFile() override;
 
 	public:
-		void insert() override;
-
-		TextMap16(const Configuration& config);
+		TextMap16(const Configuration& config, std::shared_ptr<RomImage> rom_image = nullptr,
+			std::shared_ptr<StepCache> step_cache = nullptr);
 	};
 }
@@ -1,8 +1,9 @@
 #include "title_moves.h"
 
 namespace callisto {
-	TitleMoves::TitleMoves(const Configuration& config)
-		: LunarMagicInsertable(config), title_moves_path(registerConfigurationDependency(config.title_moves).getOrThrow())
+	TitleMoves::TitleMoves(const Configuration& config, std::shared_ptr<RomImage> rom_image,
+		std::shared_ptr<StepCache> step_cache)
+		: LunarMagicInsertable(config, rom_image, step_cache), title_moves_path(registerConfigurationDependency(config.title_moves).getOrThrow())
 	{
 
 	}
@@ -13,7 +14,7 @@ namespace callisto {
 		return dependencies;
 	}
 
-	void TitleMoves::insert() {
+	void TitleMoves::insertIntoRomFile() {
 		if (!fs::exists(title_moves_path)) {
 			throw ResourceNotFoundException(fmt::format(
 				colors::EXCEPTION,
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <filesystem>
+#include <optional>
+#include <vector>
+#include <string>
+#include <cstdlib>
 
 #include <platform_folders.h>
 
@@ -23,11 +27,21 @@ namespace callisto {
 
 		static constexpr auto BUILD_REPORT_FILE_NAME{ "build_report.json" };
 		static constexpr auto LAST_ROM_SYNC_TIME_FILE_NAME{ "last_rom_sync.json" };
+		static constexpr auto WRITE_LEDGER_FILE_NAME{ "write_ledger.bin" };
+		static constexpr auto OWNERSHIP_INDEX_FILE_NAME{ "ownership_index.bin" };
+		static constexpr auto FREESPACE_INDEX_FILE_NAME{ "freespace_index.json" };
+		static constexpr auto STEP_CACHE_DIRECTORY_NAME{ "steps" };
+		static constexpr auto BUILD_CACHE_DIRECTORY_NAME{ "builds" };
+		static constexpr auto CHECKPOINT_DIRECTORY_NAME{ "checkpoints" };
+		static constexpr auto BUILD_JOURNAL_FILE_NAME{ "build_journal.json" };
+		static constexpr auto BASE_IMAGE_CACHE_DIRECTORY_NAME{ "base_images" };
 		static constexpr auto ASSEMBLY_INFO_FILE{ "callisto.asm" };
 		static constexpr auto USER_SETTINGS_FOLDER_NAME{ "callisto" };
 		static constexpr auto RECENT_PROJECTS_FILE{ "recent_projects.json" };
 		static constexpr auto TEMPORARY_SUFFIX{ "_temp" };
 		static constexpr auto TEMPORARY_RESOURCES_FOLDER_NAME{ "resources" };
+		static constexpr auto IN_MEMORY_FOLDER_NAME{ "callisto" };
+		static constexpr auto PROJECT_ROOT_PLACEHOLDER{ "<project root>" };
 
 	public:
 		static fs::path normalize(const fs::path& path, const fs::path& relative_to) {
@@ -38,6 +52,30 @@ namespace callisto {
 			return fs::absolute(fs::weakly_canonical(relative_to / path));
 		}
 
+		// Paths inside the project are stored relative to it, so anything that records them still matches
+		// after the project has been cloned somewhere else, paths outside of it are kept as they are
+		static std::string toPortable(const fs::path& path, const fs::path& project_root) {
+			const auto relative{ path.lexically_relative(project_root) };
+			if (path.is_absolute() && !relative.empty() && *relative.begin() != "..") {
+				return relative.generic_string();
+			}
+			return path.generic_string();
+		}
+
+		static fs::path fromPortable(const std::string& portable, const fs::path& project_root) {
+			return normalize(portable, project_root);
+		}
+
+		// For text that may mention paths inside the project, like generated patches, only meant for hashing
+		static std::string toPortableText(std::string text, const fs::path& project_root) {
+			for (const auto& root : { project_root.string(), project_root.generic_string(), sanitizeForAsar(project_root).string() }) {
+				if (!root.empty()) {
+					boost::replace_all(text, root, PROJECT_ROOT_PLACEHOLDER);
+				}
+			}
+			return text;
+		}
+
 		static fs::path sanitizeForAsar(const fs::path& path) {
 			auto as_string{ path.string() };
 			boost::replace_all(as_string, "!", "\\!");
@@ -57,6 +95,10 @@ namespace callisto {
 		static fs::path getRecentProjectsPath() {
 			return getUserWideCachePath() / RECENT_PROJECTS_FILE;
 		}
+
+		static fs::path getBaseImageCacheDirectoryPath() {
+			return getUserWideCachePath() / BASE_IMAGE_CACHE_DIRECTORY_NAME;
+		}
  
 		static fs::path getCallistoDirectoryPath(const fs::path& project_root) {
 			return project_root / CALLISTO_DIRECTORY_NAME;
@@ -74,6 +116,42 @@ namespace callisto {
 			return getCallistoCachePath(project_root) / LAST_ROM_SYNC_TIME_FILE_NAME;
 		}
 
+		static fs::path getWriteLedgerPath(const fs::path& project_root) {
+			return getCallistoCachePath(project_root) / WRITE_LEDGER_FILE_NAME;
+		}
+
+		static fs::path getOwnershipIndexPath(const fs::path& project_root) {
+			return getCallistoCachePath(project_root) / OWNERSHIP_INDEX_FILE_NAME;
+		}
+
+		static fs::path getFreespaceIndexPath(const fs::path& project_root) {
+			return getCallistoCachePath(project_root) / FREESPACE_INDEX_FILE_NAME;
+		}
+
+		static fs::path getStepCacheDirectoryPath(const fs::path& project_root) {
+			return getCallistoCachePath(project_root) / STEP_CACHE_DIRECTORY_NAME;
+		}
+
+		static fs::path getBuildCacheDirectoryPath(const fs::path& project_root) {
+			return getCallistoCachePath(project_root) / BUILD_CACHE_DIRECTORY_NAME;
+		}
+
+		static fs::path getCheckpointDirectoryPath(const fs::path& project_root) {
+			return getCallistoCachePath(project_root) / CHECKPOINT_DIRECTORY_NAME;
+		}
+
+		static fs::path getBuildJournalPath(const fs::path& project_root) {
+			return getCallistoCachePath(project_root) / BUILD_JOURNAL_FILE_NAME;
+		}
+
+		static fs::path getSharedStepCacheDirectoryPath(const fs::path& shared_directory) {
+			return shared_directory / STEP_CACHE_DIRECTORY_NAME;
+		}
+
+		static fs::path getSharedBuildCacheDirectoryPath(const fs::path& shared_directory) {
+			return shared_directory / BUILD_CACHE_DIRECTORY_NAME;
+		}
+
 		static fs::path getModuleCacheDirectoryPath(const fs::path& project_root) {
 			return getCallistoCachePath(project_root) / MODULES_DIRECTORY_NAME;
 		}
@@ -103,6 +181,38 @@ namespace callisto {
 			return temporary_folder_path / fs::path(output_rom_path.stem().string() + TEMPORARY_SUFFIX + output_rom_path.extension().string());
 		}
 
+		// Files tools like Lunar Magic and PIXI write next to the temporary ROM, named after it
+		static std::vector<fs::path> getTemporaryRomSideFiles(const fs::path& temporary_rom_path) {
+			std::vector<fs::path> side_files{};
+			for (const auto& entry : fs::directory_iterator(temporary_rom_path.parent_path())) {
+				if (entry.is_regular_file() && entry.path() != temporary_rom_path
+					&& entry.path().stem().string().starts_with(temporary_rom_path.stem().string())) {
+					side_files.push_back(entry.path());
+				}
+			}
+			return side_files;
+		}
+
+		// A directory on a RAM backed file system, if there is one
+		static std::optional<fs::path> getInMemoryDirectoryPath() {
+#ifdef _WIN32
+			return {};
+#else
+			std::vector<fs::path> candidates{ "/dev/shm" };
+			if (const auto runtime_dir{ std::getenv("XDG_RUNTIME_DIR") }; runtime_dir != nullptr) {
+				candidates.push_back(runtime_dir);
+			}
+
+			for (const auto& candidate : candidates) {
+				std::error_code error{};
+				if (fs::is_directory(candidate, error)) {
+					return candidate / IN_MEMORY_FOLDER_NAME;
+				}
+			}
+			return {};
+#endif
+		}
+
 		static fs::path getTemporaryResourcePathFor(const fs::path& temporary_folder_path, const fs::path& resource_name) {
 			const auto resource_folder_path{ temporary_folder_path / TEMPORARY_RESOURCES_FOLDER_NAME };
 			fs::create_directories(resource_folder_path);
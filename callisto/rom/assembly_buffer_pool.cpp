@@ -0,0 +1,29 @@
+#include "assembly_buffer_pool.h"
+
+namespace callisto {
+	std::mutex AssemblyBufferPool::mutex{};
+	std::vector<AssemblyBufferPool::Buffer> AssemblyBufferPool::free_buffers{};
+
+	AssemblyBufferPool::Buffer AssemblyBufferPool::acquire() {
+		{
+			std::lock_guard lock{ mutex };
+			if (!free_buffers.empty()) {
+				auto buffer{ std::move(free_buffers.back()) };
+				free_buffers.pop_back();
+				return buffer;
+			}
+		}
+
+		// asar only ever reads the bytes it's told the ROM has, so there is no need to zero this
+		return std::make_unique_for_overwrite<char[]>(BUFFER_SIZE);
+	}
+
+	void AssemblyBufferPool::release(Buffer&& buffer) {
+		if (buffer == nullptr) {
+			return;
+		}
+
+		std::lock_guard lock{ mutex };
+		free_buffers.push_back(std::move(buffer));
+	}
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+
+namespace callisto {
+	// Buffers asar assembles into, these need to be large enough for the biggest ROM asar can
+	// produce, so they are handed out uninitialized and reused rather than allocated per step
+	class AssemblyBufferPool {
+	public:
+		using Buffer = std::unique_ptr<char[]>;
+
+		static constexpr size_t BUFFER_SIZE{ 16 * 1024 * 1024 };
+
+	protected:
+		static std::mutex mutex;
+		static std::vector<Buffer> free_buffers;
+
+	public:
+		static Buffer acquire();
+		static void release(Buffer&& buffer);
+	};
+}
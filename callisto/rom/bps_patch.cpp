@@ -0,0 +1,120 @@
+#include "bps_patch.h"
+
+namespace callisto {
+	uint64_t BpsPatch::readNumber(std::span<const char> patch, size_t& offset) {
+		uint64_t number{ 0 };
+		uint64_t shift{ 1 };
+		while (true) {
+			if (offset >= patch.size() - FOOTER_SIZE) {
+				throw InvalidPatch("BPS patch is truncated");
+			}
+			const auto byte{ static_cast<unsigned char>(patch[offset++]) };
+			number += (byte & 0x7F) * shift;
+			if ((byte & 0x80) != 0) {
+				return number;
+			}
+			shift <<= 7;
+			number += shift;
+		}
+	}
+
+	uint32_t BpsPatch::readChecksum(std::span<const char> patch, size_t offset) {
+		uint32_t value{ 0 };
+		for (size_t i{ 0 }; i != 4; ++i) {
+			value |= static_cast<uint32_t>(static_cast<unsigned char>(patch[offset + i])) << (i * 8);
+		}
+		return value;
+	}
+
+	int64_t BpsPatch::readRelativeOffset(std::span<const char> patch, size_t& offset) {
+		const auto number{ readNumber(patch, offset) };
+		const auto magnitude{ static_cast<int64_t>(number >> 1) };
+		return (number & 1) != 0 ? -magnitude : magnitude;
+	}
+
+	uint32_t BpsPatch::checksum(std::span<const char> bytes) {
+		boost::crc_32_type crc{};
+		crc.process_bytes(bytes.data(), bytes.size());
+		return crc.checksum();
+	}
+
+	std::vector<char> BpsPatch::apply(std::span<const char> source, std::span<const char> patch) {
+		if (patch.size() < sizeof(MAGIC) + FOOTER_SIZE || !std::equal(std::begin(MAGIC), std::end(MAGIC), patch.begin())) {
+			throw InvalidPatch("Not a BPS patch");
+		}
+
+		const auto footer{ patch.size() - FOOTER_SIZE };
+		if (checksum(patch.subspan(0, footer + 8)) != readChecksum(patch, footer + 8)) {
+			throw InvalidPatch("BPS patch is corrupted");
+		}
+
+		size_t offset{ sizeof(MAGIC) };
+		const auto source_size{ readNumber(patch, offset) };
+		const auto target_size{ readNumber(patch, offset) };
+		const auto metadata_size{ readNumber(patch, offset) };
+		offset += metadata_size;
+
+		if (source_size != source.size() || checksum(source) != readChecksum(patch, footer)) {
+			throw InvalidPatch("BPS patch was made for a different ROM");
+		}
+
+		std::vector<char> target(target_size);
+		size_t output_offset{ 0 };
+		int64_t source_relative_offset{ 0 };
+		int64_t target_relative_offset{ 0 };
+
+		while (offset < footer) {
+			const auto data{ readNumber(patch, offset) };
+			const auto action{ static_cast<Action>(data & 3) };
+			const auto length{ (data >> 2) + 1 };
+			if (length > target_size - output_offset) {
+				throw InvalidPatch("BPS patch writes past the end of the ROM");
+			}
+
+			switch (action) {
+			case SOURCE_READ:
+				if (output_offset + length > source.size()) {
+					throw InvalidPatch("BPS patch reads past the end of the source ROM");
+				}
+				std::copy_n(source.begin() + output_offset, length, target.begin() + output_offset);
+				break;
+
+			case TARGET_READ:
+				if (length > footer - offset) {
+					throw InvalidPatch("BPS patch is truncated");
+				}
+				std::copy_n(patch.begin() + offset, length, target.begin() + output_offset);
+				offset += length;
+				break;
+
+			case SOURCE_COPY:
+				source_relative_offset += readRelativeOffset(patch, offset);
+				if (source_relative_offset < 0 || source_relative_offset + length > source.size()) {
+					throw InvalidPatch("BPS patch reads past the end of the source ROM");
+				}
+				std::copy_n(source.begin() + source_relative_offset, length, target.begin() + output_offset);
+				source_relative_offset += length;
+				break;
+
+			case TARGET_COPY:
+				target_relative_offset += readRelativeOffset(patch, offset);
+				if (target_relative_offset < 0 || static_cast<uint64_t>(target_relative_offset) >= output_offset) {
+					throw InvalidPatch("BPS patch copies from a part of the ROM that hasn't been written yet");
+				}
+				// byte by byte, the ranges may overlap to repeat a pattern
+				for (uint64_t i{ 0 }; i != length; ++i) {
+					target[output_offset + i] = target[target_relative_offset++];
+				}
+				break;
+			}
+
+			output_offset += length;
+		}
+
+		if (output_offset != target_size || checksum(target) != readChecksum(patch, footer + 4)) {
+			throw InvalidPatch("BPS patch produced a ROM that doesn't match its checksum");
+		}
+
+		return target;
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#include <boost/crc.hpp>
+
+#include "../callisto_exception.h"
+
+namespace callisto {
+	// Applies BPS patches in memory, so a patched ROM can be had without writing the source to disk
+	// and launching FLIPS, the checksums in the patch are checked the same way FLIPS does
+	class BpsPatch {
+	protected:
+		static constexpr char MAGIC[]{ 'B', 'P', 'S', '1' };
+		static constexpr size_t FOOTER_SIZE{ 12 };
+
+		enum Action {
+			SOURCE_READ,
+			TARGET_READ,
+			SOURCE_COPY,
+			TARGET_COPY
+		};
+
+		static uint64_t readNumber(std::span<const char> patch, size_t& offset);
+		static uint32_t readChecksum(std::span<const char> patch, size_t offset);
+		static int64_t readRelativeOffset(std::span<const char> patch, size_t& offset);
+		static uint32_t checksum(std::span<const char> bytes);
+
+	public:
+		class InvalidPatch : public CallistoException {
+			using CallistoException::CallistoException;
+		};
+
+		// Throws InvalidPatch if the patch is malformed or wasn't made for source
+		static std::vector<char> apply(std::span<const char> source, std::span<const char> patch);
+	};
+}
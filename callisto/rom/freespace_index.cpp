@@ -0,0 +1,191 @@
+#include "freespace_index.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace callisto {
+	double FreespaceIndex::BankUsage::fragmentation() const {
+		if (free_bytes == 0) {
+			return 0.0;
+		}
+		return 1.0 - static_cast<double>(largest_free_run) / free_bytes;
+	}
+
+	FreespaceIndex::FreespaceIndex(std::span<const char> rom, RomView::Mapper mapper) : mapper(mapper) {
+		for (size_t bank_start{ EXPANDED_AREA_START }; bank_start < rom.size(); bank_start += BANK_SIZE) {
+			const auto snes_address{ RomView::pcToSnes(static_cast<int>(bank_start), mapper) };
+			banks.push_back({ snes_address.has_value() ? snes_address.value() >> 16 : -1, 0, 0, 0, 0 });
+		}
+
+		const auto bank_of{ [&](size_t pc_offset) -> BankUsage& {
+			return banks[(pc_offset - EXPANDED_AREA_START) / BANK_SIZE];
+		} };
+
+		std::optional<size_t> run_start{};
+		const auto finish_run{ [&](size_t run_end) {
+			if (run_start.has_value() && run_end - run_start.value() >= MIN_FREE_RUN) {
+				auto& bank{ bank_of(run_start.value()) };
+				const auto run_size{ run_end - run_start.value() };
+				bank.free_bytes += run_size;
+				++bank.free_runs;
+				bank.largest_free_run = std::max(bank.largest_free_run, run_size);
+			}
+			run_start.reset();
+		} };
+
+		size_t pc_offset{ EXPANDED_AREA_START };
+		while (pc_offset < rom.size()) {
+			if (pc_offset % BANK_SIZE == 0) {
+				finish_run(pc_offset);
+			}
+
+			const auto block_size{ rom[pc_offset] == Rats::TAG_TEXT[0] ? Rats::blockSize(rom, pc_offset) : std::nullopt };
+			if (block_size.has_value()) {
+				finish_run(pc_offset);
+
+				const auto block_end{ std::min(rom.size(), pc_offset + Rats::TAG_SIZE + block_size.value()) };
+				blocks.push_back({ pc_offset, block_end - pc_offset, {} });
+
+				// blocks may run across bank borders
+				while (pc_offset != block_end) {
+					const auto bank_end{ std::min(block_end, (pc_offset / BANK_SIZE + 1) * BANK_SIZE) };
+					bank_of(pc_offset).protected_bytes += bank_end - pc_offset;
+					pc_offset = bank_end;
+				}
+				continue;
+			}
+
+			if (rom[pc_offset] == FREESPACE_BYTE) {
+				if (!run_start.has_value()) {
+					run_start = pc_offset;
+				}
+			}
+			else {
+				finish_run(pc_offset);
+			}
+			++pc_offset;
+		}
+		finish_run(rom.size());
+	}
+
+	void FreespaceIndex::assignOwner(int snes_address, const std::string& owner) {
+		const auto pc_offset{ RomView::snesToPc(snes_address, mapper) };
+		if (!pc_offset.has_value()) {
+			return;
+		}
+
+		const auto after{ std::upper_bound(blocks.begin(), blocks.end(), static_cast<size_t>(pc_offset.value()),
+			[](size_t offset, const ProtectedBlock& block) { return offset < block.start; }) };
+		if (after == blocks.begin()) {
+			return;
+		}
+
+		auto& block{ *std::prev(after) };
+		if (static_cast<size_t>(pc_offset.value()) < block.start + block.size && !block.owner.has_value()) {
+			block.owner = owner;
+		}
+	}
+
+	void FreespaceIndex::assignOwners(const OwnershipIndex& ownership_index) {
+		for (auto& block : blocks) {
+			if (block.owner.has_value()) {
+				continue;
+			}
+
+			std::unordered_map<uint32_t, size_t> written_bytes{};
+			for (const auto& interval : ownership_index.query(block.start, block.start + block.size)) {
+				written_bytes[interval.writer] += interval.end - interval.start;
+			}
+
+			const auto most_written{ std::max_element(written_bytes.begin(), written_bytes.end(),
+				[](const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; }) };
+			if (most_written != written_bytes.end()) {
+				block.owner = ownership_index.getWriterName(most_written->first);
+			}
+		}
+	}
+
+	size_t FreespaceIndex::getFreeBytes() const {
+		size_t free_bytes{ 0 };
+		for (const auto& bank : banks) {
+			free_bytes += bank.free_bytes;
+		}
+		return free_bytes;
+	}
+
+	size_t FreespaceIndex::getLargestFreeRun() const {
+		size_t largest_free_run{ 0 };
+		for (const auto& bank : banks) {
+			largest_free_run = std::max(largest_free_run, bank.largest_free_run);
+		}
+		return largest_free_run;
+	}
+
+	double FreespaceIndex::getFragmentation() const {
+		// since blocks can't span banks, a bank's largest run is as good as it gets for it
+		size_t free_bytes{ 0 };
+		size_t usable_bytes{ 0 };
+		for (const auto& bank : banks) {
+			free_bytes += bank.free_bytes;
+			usable_bytes += bank.largest_free_run;
+		}
+		return free_bytes == 0 ? 0.0 : 1.0 - static_cast<double>(usable_bytes) / free_bytes;
+	}
+
+	json FreespaceIndex::toJson() const {
+		json j{};
+		j["version"] = FORMAT_VERSION;
+		j["mapper"] = static_cast<int>(mapper);
+
+		j["blocks"] = json::array();
+		for (const auto& block : blocks) {
+			j["blocks"].push_back({
+				{ "start", block.start },
+				{ "size", block.size },
+				{ "owner", block.owner.has_value() ? json(block.owner.value()) : json(nullptr) }
+			});
+		}
+
+		j["banks"] = json::array();
+		for (const auto& bank : banks) {
+			j["banks"].push_back({
+				{ "bank", bank.bank },
+				{ "protected_bytes", bank.protected_bytes },
+				{ "free_bytes", bank.free_bytes },
+				{ "free_runs", bank.free_runs },
+				{ "largest_free_run", bank.largest_free_run }
+			});
+		}
+
+		return j;
+	}
+
+	FreespaceIndex FreespaceIndex::fromJson(const json& j) {
+		if (j.value("version", 0u) != FORMAT_VERSION) {
+			throw CallistoException("Freespace index was written by a different version of callisto");
+		}
+
+		FreespaceIndex index{};
+		index.mapper = static_cast<RomView::Mapper>(j["mapper"].get<int>());
+
+		for (const auto& block : j["blocks"]) {
+			index.blocks.push_back({
+				block["start"].get<size_t>(),
+				block["size"].get<size_t>(),
+				block["owner"].is_null() ? std::nullopt : std::make_optional(block["owner"].get<std::string>())
+			});
+		}
+
+		for (const auto& bank : j["banks"]) {
+			index.banks.push_back({
+				bank["bank"].get<int>(),
+				bank["protected_bytes"].get<size_t>(),
+				bank["free_bytes"].get<size_t>(),
+				bank["free_runs"].get<size_t>(),
+				bank["largest_free_run"].get<size_t>()
+			});
+		}
+
+		return index;
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+
+#include <nlohmann/json.hpp>
+
+#include "rats.h"
+#include "rom_view.h"
+#include "../conflicts/ownership_index.h"
+
+using json = nlohmann::json;
+
+namespace callisto {
+	// RATS protected blocks and the free space between them in the expanded part of a ROM,
+	// bank by bank, so it's visible how much room is left before asar runs out of it
+	class FreespaceIndex {
+	public:
+		static constexpr uint32_t FORMAT_VERSION{ 1 };
+
+		struct ProtectedBlock {
+			// PC offset of the RATS tag, size includes the tag
+			size_t start;
+			size_t size;
+			std::optional<std::string> owner;
+		};
+
+		struct BankUsage {
+			int bank;
+			size_t protected_bytes;
+			size_t free_bytes;
+			size_t free_runs;
+			size_t largest_free_run;
+
+			// 0 when all free bytes are in one run, approaching 1 the more they're scattered
+			double fragmentation() const;
+		};
+
+	protected:
+		// asar never puts freespace into the original ROM and can't place blocks across banks
+		static constexpr size_t EXPANDED_AREA_START{ 0x80000 };
+		static constexpr size_t BANK_SIZE{ 0x8000 };
+		// anything shorter can't even hold a tag and a byte, so it's not worth counting
+		static constexpr size_t MIN_FREE_RUN{ Rats::TAG_SIZE + 1 };
+		static constexpr char FREESPACE_BYTE{ 0x00 };
+
+		RomView::Mapper mapper{ RomView::Mapper::LOROM };
+		std::vector<ProtectedBlock> blocks{};
+		std::vector<BankUsage> banks{};
+
+	public:
+		FreespaceIndex() = default;
+		FreespaceIndex(std::span<const char> rom, RomView::Mapper mapper);
+
+		// Owners are attributed to the block that protects a given SNES address
+		void assignOwner(int snes_address, const std::string& owner);
+		// Blocks that are still unowned go to whoever wrote most of them
+		void assignOwners(const OwnershipIndex& ownership_index);
+
+		const std::vector<ProtectedBlock>& getBlocks() const {
+			return blocks;
+		}
+
+		const std::vector<BankUsage>& getBanks() const {
+			return banks;
+		}
+
+		RomView::Mapper getMapper() const {
+			return mapper;
+		}
+
+		size_t getFreeBytes() const;
+		size_t getLargestFreeRun() const;
+		double getFragmentation() const;
+
+		json toJson() const;
+		static FreespaceIndex fromJson(const json& j);
+	};
+}
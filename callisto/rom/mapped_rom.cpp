@@ -0,0 +1,126 @@
+#include "mapped_rom.h"
+
+namespace callisto {
+	MappedRom::MappedRom(const fs::path& rom_path, Mode mode) : rom_path(rom_path), mode(mode) {
+		if (!fs::exists(rom_path)) {
+			throw RomNotFoundException(fmt::format("ROM not found at {}", rom_path.string()));
+		}
+
+		file_size = fs::file_size(rom_path);
+		header_size = file_size & 0x7FFF;
+		page_size = bi::mapped_region::get_page_size();
+
+		// empty files can't be mapped, there is nothing to view in them anyway
+		if (file_size == 0) {
+			return;
+		}
+
+		const auto access{ mode == Mode::READ_WRITE ? bi::read_write : bi::read_only };
+		try {
+			file_mapping = bi::file_mapping(rom_path.string().c_str(), access);
+			mapped_region = bi::mapped_region(file_mapping, access);
+		}
+		catch (const bi::interprocess_exception& e) {
+			throw CallistoException(fmt::format("Failed to map ROM {}: {}", rom_path.string(), e.what()));
+		}
+
+		data = static_cast<char*>(mapped_region.get_address());
+	}
+
+	const fs::path& MappedRom::getPath() const {
+		return rom_path;
+	}
+
+	std::span<const char> MappedRom::getHeader() const {
+		return { data, header_size };
+	}
+
+	std::span<const char> MappedRom::getBody() const {
+		return { data + header_size, file_size - header_size };
+	}
+
+	std::span<const char> MappedRom::read(size_t pc_offset, size_t size) const {
+		if (pc_offset > file_size - header_size || size > file_size - header_size - pc_offset) {
+			throw CallistoException(fmt::format(
+				"Cannot read 0x{:X} bytes at PC offset 0x{:06X} from ROM {}, which is only 0x{:X} bytes large",
+				size, pc_offset, rom_path.string(), file_size - header_size
+			));
+		}
+
+		return { data + header_size + pc_offset, size };
+	}
+
+	char* MappedRom::writableAt(size_t file_offset, size_t size) {
+		if (mode != Mode::READ_WRITE) {
+			throw CallistoException(fmt::format("ROM {} was mapped read only", rom_path.string()));
+		}
+
+		markDirty(file_offset, size);
+		return data + file_offset;
+	}
+
+	void MappedRom::write(size_t pc_offset, std::span<const char> bytes) {
+		read(pc_offset, bytes.size());
+		std::memcpy(writableAt(header_size + pc_offset, bytes.size()), bytes.data(), bytes.size());
+	}
+
+	void MappedRom::markDirty(size_t file_offset, size_t size) {
+		if (size == 0) {
+			return;
+		}
+
+		const auto start{ file_offset / page_size * page_size };
+		const auto end{ std::min((file_offset + size + page_size - 1) / page_size * page_size, file_size) };
+
+		// writes mostly arrive in ascending order, so this usually just extends the last range
+		if (!dirty_pages.empty() && dirty_pages.back().second >= start && dirty_pages.back().first <= start) {
+			dirty_pages.back().second = std::max(dirty_pages.back().second, end);
+			return;
+		}
+
+		const auto insert_at{ std::lower_bound(dirty_pages.begin(), dirty_pages.end(), PageRange{ start, end }) };
+		auto merged{ dirty_pages.insert(insert_at, { start, end }) };
+
+		if (merged != dirty_pages.begin() && std::prev(merged)->second >= merged->first) {
+			std::prev(merged)->second = std::max(std::prev(merged)->second, merged->second);
+			merged = std::prev(dirty_pages.erase(merged));
+		}
+		while (std::next(merged) != dirty_pages.end() && std::next(merged)->first <= merged->second) {
+			merged->second = std::max(merged->second, std::next(merged)->second);
+			dirty_pages.erase(std::next(merged));
+		}
+	}
+
+	size_t MappedRom::syncFrom(std::span<const char> header, std::span<const char> body) {
+		if (header.size() != header_size || body.size() != file_size - header_size) {
+			throw CallistoException(fmt::format("Size mismatch while writing to ROM {}", rom_path.string()));
+		}
+
+		if (!std::equal(header.begin(), header.end(), data)) {
+			std::memcpy(writableAt(0, header_size), header.data(), header_size);
+		}
+
+		for (const auto& [start, end] : RomDiff::changedRanges(data + header_size, body.data(), body.size())) {
+			std::memcpy(writableAt(header_size + start, end - start), body.data() + start, end - start);
+		}
+
+		size_t pages{ 0 };
+		for (const auto& [start, end] : dirty_pages) {
+			pages += (end - start + page_size - 1) / page_size;
+		}
+		return pages;
+	}
+
+	const std::vector<MappedRom::PageRange>& MappedRom::getDirtyPages() const {
+		return dirty_pages;
+	}
+
+	void MappedRom::flush() {
+		for (const auto& [start, end] : dirty_pages) {
+			if (!mapped_region.flush(start, end - start)) {
+				throw CallistoException(fmt::format("Failed to write ROM {}", rom_path.string()));
+			}
+		}
+		dirty_pages.clear();
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <fmt/format.h>
+
+#include "rom_diff.h"
+#include "../callisto_exception.h"
+#include "../not_found_exception.h"
+
+namespace fs = std::filesystem;
+namespace bi = boost::interprocess;
+
+namespace callisto {
+	// A ROM file mapped into memory, reads are views straight into the mapping and writes
+	// only dirty the pages they touch, which are the only ones flushed back
+	class MappedRom {
+	public:
+		enum class Mode {
+			READ_ONLY,
+			READ_WRITE
+		};
+
+		// [start, end) of a run of dirty bytes in the file, page aligned
+		using PageRange = std::pair<size_t, size_t>;
+
+	protected:
+		const fs::path rom_path;
+		const Mode mode;
+
+		bi::file_mapping file_mapping{};
+		bi::mapped_region mapped_region{};
+
+		char* data{ nullptr };
+		size_t file_size{ 0 };
+		size_t header_size{ 0 };
+		size_t page_size{ 0 };
+
+		std::vector<PageRange> dirty_pages{};
+
+		void markDirty(size_t file_offset, size_t size);
+		char* writableAt(size_t file_offset, size_t size);
+
+	public:
+		MappedRom(const fs::path& rom_path, Mode mode = Mode::READ_ONLY);
+
+		const fs::path& getPath() const;
+
+		std::span<const char> getHeader() const;
+		// Unheadered ROM contents
+		std::span<const char> getBody() const;
+		std::span<const char> read(size_t pc_offset, size_t size) const;
+
+		void write(size_t pc_offset, std::span<const char> bytes);
+
+		// Makes the file match the passed header and unheadered body, which must be the same size as the
+		// mapped ones, only bytes that actually differ are written, returns the number of dirty pages
+		size_t syncFrom(std::span<const char> header, std::span<const char> body);
+
+		const std::vector<PageRange>& getDirtyPages() const;
+
+		// Writes dirty pages back to the file
+		void flush();
+	};
+}
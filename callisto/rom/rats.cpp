@@ -0,0 +1,55 @@
+#include "rats.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace callisto {
+	std::optional<size_t> Rats::blockSize(std::span<const char> rom, size_t pc_offset) {
+		if (pc_offset + TAG_SIZE > rom.size() || std::memcmp(rom.data() + pc_offset, TAG_TEXT, 4) != 0) {
+			return {};
+		}
+
+		const auto byte_at{ [&](size_t offset) { return static_cast<unsigned char>(rom[pc_offset + offset]); } };
+		const auto size{ (byte_at(5) << 8) | byte_at(4) };
+		const auto size_complement{ (byte_at(7) << 8) | byte_at(6) };
+
+		if (size != (size_complement ^ 0xFFFF)) {
+			return {};
+		}
+
+		return static_cast<size_t>(size) + 1;
+	}
+
+	std::optional<size_t> Rats::findTag(std::span<const char> rom, size_t pc_offset) {
+		if (pc_offset < MIN_CLEANABLE_OFFSET || pc_offset >= rom.size()) {
+			return {};
+		}
+
+		const auto search_end{ pc_offset - std::min(pc_offset, MAX_SEARCH_DISTANCE) };
+		for (auto tag_offset{ pc_offset }; ; --tag_offset) {
+			const auto block_size{ blockSize(rom, tag_offset) };
+			if (block_size.has_value()) {
+				// like asar, only the closest tag counts, even if its block ends before pc_offset
+				if (tag_offset + TAG_SIZE + block_size.value() > pc_offset) {
+					return tag_offset;
+				}
+				return {};
+			}
+
+			if (tag_offset == search_end) {
+				return {};
+			}
+		}
+	}
+
+	bool Rats::clean(std::span<char> rom, size_t pc_offset, char clean_byte) {
+		const auto tag_offset{ findTag(rom, pc_offset) };
+		if (!tag_offset.has_value()) {
+			return false;
+		}
+
+		const auto block_end{ std::min(rom.size(), tag_offset.value() + TAG_SIZE + blockSize(rom, tag_offset.value()).value()) };
+		std::fill(rom.begin() + tag_offset.value(), rom.begin() + block_end, clean_byte);
+		return true;
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <span>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+
+namespace callisto {
+	// RATS tags protecting freespace blocks, "STAR" followed by the block's size - 1 and its complement,
+	// locating and cleaning them works the same way asar's autoclean does
+	class Rats {
+	public:
+		static constexpr auto TAG_TEXT{ "STAR" };
+		static constexpr auto TAG_SIZE{ 8 };
+
+	protected:
+		// asar doesn't look further back than this for a tag and never cleans the original 512 KB
+		static constexpr size_t MAX_SEARCH_DISTANCE{ 0x10000 };
+		static constexpr size_t MIN_CLEANABLE_OFFSET{ 0x80000 - TAG_SIZE };
+
+	public:
+		// Size of the block protected by the tag at pc_offset, excluding the tag itself
+		static std::optional<size_t> blockSize(std::span<const char> rom, size_t pc_offset);
+
+		// PC offset of the tag whose block contains pc_offset, if any
+		static std::optional<size_t> findTag(std::span<const char> rom, size_t pc_offset);
+
+		// Erases the tag and block containing pc_offset, returns whether anything was cleaned
+		static bool clean(std::span<char> rom, size_t pc_offset, char clean_byte = 0x00);
+	};
+}
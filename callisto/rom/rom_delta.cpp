@@ -0,0 +1,73 @@
+#include "rom_delta.h"
+
+#include <algorithm>
+
+namespace callisto {
+	RomDelta RomDelta::between(std::span<const char> before, std::span<const char> after) {
+		RomDelta delta{};
+		delta.size_before = before.size();
+		delta.size_after = after.size();
+
+		const auto compared_size{ std::min(before.size(), after.size()) };
+		for (const auto& [start, end] : RomDiff::changedRanges(before.data(), after.data(), compared_size)) {
+			delta.changes.push_back({ start, std::vector<char>(after.begin() + start, after.begin() + end) });
+		}
+
+		if (after.size() > before.size()) {
+			delta.changes.push_back({ before.size(), std::vector<char>(after.begin() + before.size(), after.end()) });
+		}
+
+		return delta;
+	}
+
+	void RomDelta::applyTo(std::span<char> rom) const {
+		if (rom.size() < std::max(size_before, size_after)) {
+			throw CallistoException("ROM is too small to apply delta to");
+		}
+
+		for (const auto& change : changes) {
+			std::copy(change.bytes.begin(), change.bytes.end(), rom.begin() + change.pc_offset);
+		}
+	}
+
+	void RomDelta::serialize(std::ostream& out) const {
+		BinaryWriter writer{ out };
+		writer.write<uint32_t>(FORMAT_VERSION);
+		writer.write<uint64_t>(size_before);
+		writer.write<uint64_t>(size_after);
+
+		writer.write<uint32_t>(static_cast<uint32_t>(changes.size()));
+		for (const auto& change : changes) {
+			writer.write<uint64_t>(change.pc_offset);
+			writer.write<uint64_t>(change.bytes.size());
+			writer.writeBytes(change.bytes);
+		}
+	}
+
+	RomDelta RomDelta::deserialize(std::istream& in) {
+		BinaryReader reader{ in, "ROM delta" };
+		if (reader.read<uint32_t>() != FORMAT_VERSION) {
+			throw CallistoException("ROM delta format has changed");
+		}
+
+		RomDelta delta{};
+		delta.size_before = reader.read<uint64_t>();
+		delta.size_after = reader.read<uint64_t>();
+
+		const auto change_count{ reader.read<uint32_t>() };
+		delta.changes.reserve(change_count);
+		for (uint32_t i{ 0 }; i != change_count; ++i) {
+			const auto pc_offset{ reader.read<uint64_t>() };
+			const auto size{ reader.read<uint64_t>() };
+			if (pc_offset + size > std::max(delta.size_before, delta.size_after)) {
+				throw CallistoException("ROM delta is malformed");
+			}
+
+			Change change{ pc_offset, std::vector<char>(size) };
+			reader.readBytes(change.bytes);
+			delta.changes.push_back(std::move(change));
+		}
+
+		return delta;
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+
+#include "rom_diff.h"
+#include "../callisto_exception.h"
+#include "../binary_io.h"
+
+namespace callisto {
+	// Everything a step changed about the unheadered ROM, so the step's effect can be replayed
+	// onto an identical ROM without running the step again
+	class RomDelta {
+	public:
+		static constexpr uint32_t FORMAT_VERSION{ 1 };
+
+		struct Change {
+			size_t pc_offset;
+			std::vector<char> bytes;
+		};
+
+	protected:
+		size_t size_before{ 0 };
+		size_t size_after{ 0 };
+		std::vector<Change> changes{};
+
+	public:
+		RomDelta() = default;
+
+		// If after is larger than before, the part past the end of before is taken over as a whole
+		static RomDelta between(std::span<const char> before, std::span<const char> after);
+
+		size_t getSizeBefore() const {
+			return size_before;
+		}
+
+		size_t getSizeAfter() const {
+			return size_after;
+		}
+
+		const std::vector<Change>& getChanges() const {
+			return changes;
+		}
+
+		// rom must hold the state this delta was taken from and have room for getSizeAfter() bytes
+		void applyTo(std::span<char> rom) const;
+
+		void serialize(std::ostream& out) const;
+		static RomDelta deserialize(std::istream& in);
+	};
+}
@@ -0,0 +1,165 @@
+#include "rom_diff.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CALLISTO_DIFF_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CALLISTO_TARGET_AVX2
+#else
+#define CALLISTO_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace callisto {
+	namespace {
+		// FIND_EQUAL = true returns the first equal byte at or after from, false the first differing one
+		template<bool FIND_EQUAL>
+		size_t scanScalar(const unsigned char* old_data, const unsigned char* new_data, size_t from, size_t size) {
+			if constexpr (!FIND_EQUAL) {
+				// unchanged stretches are by far the most common case, so skip those a word at a time
+				while (from + sizeof(uint64_t) <= size) {
+					uint64_t old_word;
+					uint64_t new_word;
+					std::memcpy(&old_word, old_data + from, sizeof(uint64_t));
+					std::memcpy(&new_word, new_data + from, sizeof(uint64_t));
+					if (old_word != new_word) {
+						break;
+					}
+					from += sizeof(uint64_t);
+				}
+			}
+
+			while (from != size && (old_data[from] == new_data[from]) != FIND_EQUAL) {
+				++from;
+			}
+			return from;
+		}
+
+#ifdef CALLISTO_DIFF_X86
+		template<bool FIND_EQUAL>
+		size_t scanSse2(const unsigned char* old_data, const unsigned char* new_data, size_t from, size_t size) {
+			while (from + 16 <= size) {
+				const auto old_chunk{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(old_data + from)) };
+				const auto new_chunk{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(new_data + from)) };
+				const auto equal_mask{ static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(old_chunk, new_chunk))) };
+				const auto hits{ FIND_EQUAL ? equal_mask : (~equal_mask & 0xFFFF) };
+				if (hits != 0) {
+					return from + std::countr_zero(hits);
+				}
+				from += 16;
+			}
+			return scanScalar<FIND_EQUAL>(old_data, new_data, from, size);
+		}
+
+		template<bool FIND_EQUAL>
+		CALLISTO_TARGET_AVX2 size_t scanAvx2(const unsigned char* old_data, const unsigned char* new_data, size_t from, size_t size) {
+			while (from + 32 <= size) {
+				const auto old_chunk{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(old_data + from)) };
+				const auto new_chunk{ _mm256_loadu_si256(reinterpret_cast<const __m256i*>(new_data + from)) };
+				const auto equal_mask{ static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(old_chunk, new_chunk))) };
+				const auto hits{ FIND_EQUAL ? equal_mask : ~equal_mask };
+				if (hits != 0) {
+					return from + std::countr_zero(hits);
+				}
+				from += 32;
+			}
+			return scanSse2<FIND_EQUAL>(old_data, new_data, from, size);
+		}
+#endif
+	}
+
+	bool RomDiff::cpuSupportsAvx2() {
+#if defined(CALLISTO_DIFF_X86) && defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) {
+			return false;
+		}
+
+		__cpuid(info, 1);
+		const bool os_uses_xsave{ (info[2] & (1 << 27)) != 0 };
+		const bool has_avx{ (info[2] & (1 << 28)) != 0 };
+		if (!os_uses_xsave || !has_avx || (_xgetbv(0) & 0x6) != 0x6) {
+			return false;
+		}
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#elif defined(CALLISTO_DIFF_X86)
+		return __builtin_cpu_supports("avx2");
+#else
+		return false;
+#endif
+	}
+
+	size_t RomDiff::findMismatch(const unsigned char* old_data, const unsigned char* new_data, size_t from, size_t size) {
+#ifdef CALLISTO_DIFF_X86
+		static const bool use_avx2{ cpuSupportsAvx2() };
+		if (use_avx2) {
+			return scanAvx2<false>(old_data, new_data, from, size);
+		}
+		return scanSse2<false>(old_data, new_data, from, size);
+#else
+		return scanScalar<false>(old_data, new_data, from, size);
+#endif
+	}
+
+	size_t RomDiff::findMatch(const unsigned char* old_data, const unsigned char* new_data, size_t from, size_t size) {
+#ifdef CALLISTO_DIFF_X86
+		static const bool use_avx2{ cpuSupportsAvx2() };
+		if (use_avx2) {
+			return scanAvx2<true>(old_data, new_data, from, size);
+		}
+		return scanSse2<true>(old_data, new_data, from, size);
+#else
+		return scanScalar<true>(old_data, new_data, from, size);
+#endif
+	}
+
+	std::vector<RomDiff::Range> RomDiff::changedRanges(const char* old_data, const char* new_data, size_t size) {
+		const auto old_bytes{ reinterpret_cast<const unsigned char*>(old_data) };
+		const auto new_bytes{ reinterpret_cast<const unsigned char*>(new_data) };
+
+		std::vector<Range> ranges{};
+		size_t position{ 0 };
+		while (true) {
+			position = findMismatch(old_bytes, new_bytes, position, size);
+			if (position == size) {
+				break;
+			}
+
+			const auto end{ findMatch(old_bytes, new_bytes, position, size) };
+			ranges.push_back({ position, end });
+			position = end;
+		}
+
+		return ranges;
+	}
+
+	std::vector<RomDiff::Range> RomDiff::changedRanges(const std::vector<char>& old_rom, const std::vector<char>& new_rom, size_t limit) {
+		return changedRanges(old_rom.data(), new_rom.data(), std::min({ old_rom.size(), new_rom.size(), limit }));
+	}
+
+	std::vector<RomDiff::Range> RomDiff::excludeRange(const std::vector<Range>& ranges, size_t start, size_t end) {
+		std::vector<Range> remaining{};
+		remaining.reserve(ranges.size() + 1);
+		for (const auto& [range_start, range_end] : ranges) {
+			if (range_end <= start || range_start >= end) {
+				remaining.push_back({ range_start, range_end });
+				continue;
+			}
+
+			if (range_start < start) {
+				remaining.push_back({ range_start, start });
+			}
+			if (range_end > end) {
+				remaining.push_back({ end, range_end });
+			}
+		}
+		return remaining;
+	}
+}
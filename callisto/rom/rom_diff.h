@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+
+namespace callisto {
+	class RomDiff {
+	public:
+		// [start, end) of a run of changed bytes
+		using Range = std::pair<size_t, size_t>;
+
+	protected:
+		static bool cpuSupportsAvx2();
+
+		static size_t findMismatch(const unsigned char* old_data, const unsigned char* new_data, size_t from, size_t size);
+		static size_t findMatch(const unsigned char* old_data, const unsigned char* new_data, size_t from, size_t size);
+
+	public:
+		// Returns the maximal runs of bytes that differ between the first size bytes of both buffers, in ascending order
+		static std::vector<Range> changedRanges(const char* old_data, const char* new_data, size_t size);
+		static std::vector<Range> changedRanges(const std::vector<char>& old_rom, const std::vector<char>& new_rom,
+			size_t limit = SIZE_MAX);
+
+		// Removes [start, end) from the passed ranges, splitting ranges that straddle it
+		static std::vector<Range> excludeRange(const std::vector<Range>& ranges, size_t start, size_t end);
+	};
+}
@@ -0,0 +1,116 @@
+#include "rom_image.h"
+
+namespace callisto {
+	RomImage::RomImage(const fs::path& rom_path) : rom_path(rom_path) {
+		reload();
+	}
+
+	RomImage::~RomImage() {
+		AssemblyBufferPool::release(std::move(assembly_buffer));
+	}
+
+	const fs::path& RomImage::getPath() const {
+		return rom_path;
+	}
+
+	const std::vector<char>& RomImage::getHeader() const {
+		return header;
+	}
+
+	const std::vector<char>& RomImage::getBody() {
+		syncBody();
+		return body;
+	}
+
+	size_t RomImage::getSize() const {
+		return body_valid ? body.size() : assembly_size;
+	}
+
+	bool RomImage::isDirty() const {
+		return dirty;
+	}
+
+	void RomImage::syncBody() {
+		if (body_valid) {
+			return;
+		}
+
+		// assign reuses body's capacity, so this is a plain copy once the ROM has stopped growing
+		body.assign(assembly_buffer.get(), assembly_buffer.get() + assembly_size);
+		body_valid = true;
+	}
+
+	char* RomImage::beginPatching() {
+		if (!buffer_valid) {
+			if (body.size() > AssemblyBufferPool::BUFFER_SIZE) {
+				throw CallistoException(fmt::format("ROM {} is larger than the maximum ROM size", rom_path.string()));
+			}
+			if (assembly_buffer == nullptr) {
+				assembly_buffer = AssemblyBufferPool::acquire();
+			}
+			std::memcpy(assembly_buffer.get(), body.data(), body.size());
+			assembly_size = body.size();
+			buffer_valid = true;
+		}
+
+		return assembly_buffer.get();
+	}
+
+	void RomImage::finishPatching(int rom_size, bool modified) {
+		if (!modified) {
+			return;
+		}
+
+		assembly_size = rom_size;
+		body_valid = false;
+		dirty = true;
+	}
+
+	void RomImage::applyDelta(const RomDelta& delta) {
+		if (delta.getSizeAfter() > AssemblyBufferPool::BUFFER_SIZE) {
+			throw CallistoException(fmt::format("ROM {} is larger than the maximum ROM size", rom_path.string()));
+		}
+
+		const auto rom_data{ beginPatching() };
+		delta.applyTo({ rom_data, AssemblyBufferPool::BUFFER_SIZE });
+		finishPatching(static_cast<int>(delta.getSizeAfter()), !delta.getChanges().empty()
+			|| delta.getSizeAfter() != delta.getSizeBefore());
+	}
+
+	void RomImage::flush() {
+		if (!dirty) {
+			return;
+		}
+
+		const auto data{ body_valid ? body.data() : assembly_buffer.get() };
+		const auto file_size{ header.size() + getSize() };
+
+		// growing the file first means the mapping covers everything, the new pages then simply differ
+		if (!fs::exists(rom_path) || fs::file_size(rom_path) != file_size) {
+			if (!fs::exists(rom_path)) {
+				std::ofstream{ rom_path, std::ios::out | std::ios::binary };
+			}
+			fs::resize_file(rom_path, file_size);
+		}
+
+		MappedRom mapped_rom{ rom_path, MappedRom::Mode::READ_WRITE };
+		mapped_rom.syncFrom(header, { data, getSize() });
+		mapped_rom.flush();
+
+		dirty = false;
+	}
+
+	void RomImage::reload() {
+		if (dirty) {
+			throw CallistoException(fmt::format("Cannot reload ROM {} as it has unsaved changes", rom_path.string()));
+		}
+
+		const MappedRom mapped_rom{ rom_path };
+		header.assign(mapped_rom.getHeader().begin(), mapped_rom.getHeader().end());
+		body.assign(mapped_rom.getBody().begin(), mapped_rom.getBody().end());
+
+		// the assembly buffer is kept around for the next asar step, its contents are outdated now though
+		body_valid = true;
+		buffer_valid = false;
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <cstddef>
+#include <cstring>
+
+#include <fmt/format.h>
+
+#include "assembly_buffer_pool.h"
+#include "mapped_rom.h"
+#include "rom_delta.h"
+#include "../callisto_exception.h"
+#include "../not_found_exception.h"
+
+namespace fs = std::filesystem;
+
+namespace callisto {
+	// The temporary ROM held in memory for the duration of a build, steps that run in
+	// process work on this directly and the file is only synced around steps that need it
+	//
+	// While asar steps run the ROM lives in a pooled assembly buffer, so consecutive asar steps
+	// don't copy it around at all, the body is only brought up to date once someone asks for it
+	class RomImage {
+	protected:
+		const fs::path rom_path;
+
+		std::vector<char> header{};
+		std::vector<char> body{};
+		bool dirty{ false };
+
+		AssemblyBufferPool::Buffer assembly_buffer{};
+		size_t assembly_size{ 0 };
+		// whether assembly_buffer holds the current ROM, and whether body does
+		bool buffer_valid{ false };
+		bool body_valid{ true };
+
+		void syncBody();
+
+	public:
+		RomImage(const fs::path& rom_path);
+		~RomImage();
+
+		RomImage(const RomImage&) = delete;
+		RomImage& operator=(const RomImage&) = delete;
+
+		const fs::path& getPath() const;
+		const std::vector<char>& getHeader() const;
+
+		// Unheadered ROM contents
+		const std::vector<char>& getBody();
+		size_t getSize() const;
+
+		bool isDirty() const;
+
+		// Returns a buffer of AssemblyBufferPool::BUFFER_SIZE bytes holding the unheadered ROM for asar
+		// to patch in place, until finishPatching is called with the resulting size
+		char* beginPatching();
+		void finishPatching(int rom_size, bool modified);
+
+		// Replays a recorded step, the delta must have been taken from the current contents
+		void applyDelta(const RomDelta& delta);
+
+		// Writes the image to disk if it has changed since it was last loaded or flushed,
+		// only pages that differ from what's on disk are written
+		void flush();
+		// Picks up changes made to the file by something else, throws if there are unflushed changes
+		void reload();
+	};
+}
@@ -0,0 +1,42 @@
+#include "rom_merge.h"
+
+namespace callisto {
+	char RomMerge::expansionFiller(std::span<const char> expanded_area) {
+		std::array<size_t, 0x100> counts{};
+		for (const auto byte : expanded_area) {
+			++counts[static_cast<unsigned char>(byte)];
+		}
+		return static_cast<char>(std::distance(counts.begin(), std::max_element(counts.begin(), counts.end())));
+	}
+
+	std::vector<char> RomMerge::threeWay(std::span<const char> clean, std::span<const char> ours, std::span<const char> theirs) {
+		if (ours.size() < clean.size() || theirs.size() < clean.size()) {
+			throw CallistoException("ROMs to merge can't be smaller than the ROM they were made from");
+		}
+
+		std::vector<char> merged(std::max(ours.size(), theirs.size()));
+		for (size_t i{ 0 }; i != clean.size(); ++i) {
+			const auto ours_changed{ ours[i] != clean[i] };
+			const auto theirs_changed{ theirs[i] != clean[i] };
+			if (ours_changed && theirs_changed && ours[i] != theirs[i]) {
+				throw Conflict(fmt::format("Both ROMs change PC offset 0x{:06X}", i));
+			}
+			merged[i] = theirs_changed ? theirs[i] : ours[i];
+		}
+
+		const auto ours_filler{ expansionFiller(ours.subspan(clean.size())) };
+		const auto theirs_filler{ expansionFiller(theirs.subspan(clean.size())) };
+		for (size_t i{ clean.size() }; i != merged.size(); ++i) {
+			const auto in_ours{ i < ours.size() };
+			const auto in_theirs{ i < theirs.size() };
+			const auto ours_changed{ in_ours && ours[i] != ours_filler };
+			const auto theirs_changed{ in_theirs && theirs[i] != theirs_filler };
+			if (ours_changed && theirs_changed && ours[i] != theirs[i]) {
+				throw Conflict(fmt::format("Both ROMs change expanded PC offset 0x{:06X}", i));
+			}
+			merged[i] = theirs_changed || !in_ours ? theirs[i] : ours[i];
+		}
+
+		return merged;
+	}
+}
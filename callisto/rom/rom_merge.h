@@ -0,0 +1,34 @@
+#pragma once
+
+#include <span>
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "../callisto_exception.h"
+
+namespace callisto {
+	// Three way merges of two unheadered ROMs made from the same clean ROM, e.g. the graphics base ROM and
+	// the target of a BPS patch
+	//
+	// Past the end of the clean ROM there is nothing to compare against, so there each side's bytes are compared
+	// against the filler its expansion left behind (whatever byte value is most common in its expanded area),
+	// otherwise two expanded ROMs would always conflict, even though the data in both is in RATS protected
+	// freespace and overlapping data would differ in its RATS tags at the least
+	class RomMerge {
+	protected:
+		static char expansionFiller(std::span<const char> expanded_area);
+
+	public:
+		class Conflict : public CallistoException {
+			using CallistoException::CallistoException;
+		};
+
+		// Both sides must be at least as large as the clean ROM, where neither side changed an expanded byte,
+		// ours is kept, throws Conflict if both sides changed a byte to different values
+		static std::vector<char> threeWay(std::span<const char> clean, std::span<const char> ours, std::span<const char> theirs);
+	};
+}
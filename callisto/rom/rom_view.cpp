@@ -0,0 +1,147 @@
+#include "rom_view.h"
+
+namespace callisto {
+	RomView::RomView(std::span<const char> rom) : rom(rom), mapper(detectMapper(rom)) {}
+
+	RomView::RomView(std::span<const char> rom, Mapper mapper) : rom(rom), mapper(mapper) {}
+
+	RomView::Mapper RomView::detectMapper(std::span<const char> rom) {
+		if (rom.size() > MAP_MODE_LOCATION && static_cast<uint8_t>(rom[MAP_MODE_LOCATION]) == SA1_MAP_MODE) {
+			return Mapper::SA1;
+		}
+
+		// Lunar Magic's 8 MB expansion moves the upper half into banks $40-$7D
+		if (rom.size() > LOROM_MAX_SIZE) {
+			return Mapper::EXLOROM;
+		}
+
+		return Mapper::LOROM;
+	}
+
+	// SA-1 and ExLoROM follow asar's snestopc/pctosnes with the default SA-1 bank setup, LoROM
+	// only accepts the upper half of banks like callisto always has
+	std::optional<int> RomView::snesToPc(int snes_address, Mapper mapper) {
+		if (snes_address < 0 || snes_address > 0xFFFFFF) {
+			return {};
+		}
+
+		switch (mapper) {
+		case Mapper::LOROM: {
+			const auto bank{ (snes_address >> 16) & 0xFF };
+			if ((snes_address & 0x8000) == 0 || bank == 0x7E || bank == 0x7F) {
+				return {};
+			}
+			return ((snes_address & 0x7F0000) >> 1) | (snes_address & 0x7FFF);
+		}
+
+		case Mapper::EXLOROM: {
+			if ((snes_address & 0xF00000) == 0x700000 || (snes_address & 0x408000) == 0x000000) {
+				return {};
+			}
+			// banks $80-$FF hold the first 4 MB, $00-$7D the second
+			const auto address{ (snes_address & 0x800000) != 0 ? snes_address & 0x7FFFFF : snes_address | 0x800000 };
+			return ((address & 0xFF0000) >> 1) | (address & 0x7FFF);
+		}
+
+		case Mapper::SA1: {
+			static constexpr int SA1_BANKS[8]{ 0 << 20, 1 << 20, -1, -1, 2 << 20, 3 << 20, -1, -1 };
+			if ((snes_address & 0x408000) == 0x008000) {
+				const auto bank{ SA1_BANKS[(snes_address & 0xE00000) >> 21] };
+				if (bank == -1) {
+					return {};
+				}
+				return bank | ((snes_address & 0x1F0000) >> 1) | (snes_address & 0x7FFF);
+			}
+			if ((snes_address & 0xC00000) == 0xC00000) {
+				const auto bank{ SA1_BANKS[((snes_address & 0x100000) >> 20) | ((snes_address & 0x200000) >> 19)] };
+				return bank | (snes_address & 0x0FFFFF);
+			}
+			return {};
+		}
+		}
+
+		return {};
+	}
+
+	std::optional<int> RomView::pcToSnes(int pc_offset, Mapper mapper) {
+		if (pc_offset < 0) {
+			return {};
+		}
+
+		switch (mapper) {
+		case Mapper::LOROM: {
+			if (pc_offset >= LOROM_MAX_SIZE) {
+				return {};
+			}
+			const auto snes_address{ ((pc_offset << 1) & 0x7F0000) | (pc_offset & 0x7FFF) | 0x8000 };
+			// banks $70-$7F are SRAM and WRAM, so use their $F0-$FF mirrors instead
+			return (snes_address & 0xF00000) == 0x700000 ? snes_address | 0x800000 : snes_address;
+		}
+
+		case Mapper::EXLOROM:
+			// the second half would continue into the SRAM and WRAM banks from $70 on
+			if (pc_offset >= LOROM_MAX_SIZE + 0x380000) {
+				return {};
+			}
+			if (pc_offset >= LOROM_MAX_SIZE) {
+				return (((pc_offset - LOROM_MAX_SIZE) << 1) & 0x7F0000) | (pc_offset & 0x7FFF) | 0x8000;
+			}
+			return ((pc_offset << 1) & 0x7F0000) | (pc_offset & 0x7FFF) | 0x808000;
+
+		case Mapper::SA1:
+			if (pc_offset >= LOROM_MAX_SIZE) {
+				return {};
+			}
+			// banks $00-$3F for the first 2 MB, $80-$BF for the rest
+			return ((pc_offset & 0x200000) << 2) | ((pc_offset & 0x1F8000) << 1) | (pc_offset & 0x7FFF) | 0x8000;
+		}
+
+		return {};
+	}
+
+	RomView::Mapper RomView::getMapper() const {
+		return mapper;
+	}
+
+	size_t RomView::getSize() const {
+		return rom.size();
+	}
+
+	std::optional<int> RomView::snesToPc(int snes_address) const {
+		return snesToPc(snes_address, mapper);
+	}
+
+	std::optional<int> RomView::pcToSnes(int pc_offset) const {
+		return pcToSnes(pc_offset, mapper);
+	}
+
+	size_t RomView::toPc(int snes_address, size_t size) const {
+		const auto pc_offset{ snesToPc(snes_address) };
+		if (!pc_offset.has_value() || pc_offset.value() + size > rom.size()) {
+			throw CallistoException(fmt::format("SNES address ${:06X} does not map to the ROM", snes_address));
+		}
+		return pc_offset.value();
+	}
+
+	uint8_t RomView::read1(int snes_address) const {
+		return static_cast<uint8_t>(rom[toPc(snes_address, 1)]);
+	}
+
+	uint16_t RomView::read2(int snes_address) const {
+		return read1(snes_address) | (read1(snes_address + 1) << 8);
+	}
+
+	uint32_t RomView::read3(int snes_address) const {
+		return read2(snes_address) | (read1(snes_address + 2) << 16);
+	}
+
+	std::span<const char> RomView::view(size_t pc_offset, size_t size) const {
+		if (pc_offset > rom.size() || size > rom.size() - pc_offset) {
+			throw CallistoException(fmt::format(
+				"Cannot view 0x{:X} bytes at PC offset 0x{:06X} of a ROM that is only 0x{:X} bytes large",
+				size, pc_offset, rom.size()
+			));
+		}
+		return rom.subspan(pc_offset, size);
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <span>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+
+#include <fmt/format.h>
+
+#include "../callisto_exception.h"
+
+namespace callisto {
+	// Read only view of an unheadered ROM that knows how its SNES addresses map to PC offsets,
+	// the viewed bytes are not copied, so they must outlive the view
+	class RomView {
+	public:
+		enum class Mapper {
+			LOROM,
+			SA1,
+			EXLOROM
+		};
+
+	protected:
+		static constexpr auto MAP_MODE_LOCATION{ 0x7FD5 };
+		static constexpr auto SA1_MAP_MODE{ 0x23 };
+		static constexpr auto LOROM_MAX_SIZE{ 0x400000 };
+
+		std::span<const char> rom;
+		Mapper mapper;
+
+		size_t toPc(int snes_address, size_t size) const;
+
+	public:
+		RomView(std::span<const char> rom);
+		RomView(std::span<const char> rom, Mapper mapper);
+
+		// Determined from the map mode byte of the internal header and the ROM's size
+		static Mapper detectMapper(std::span<const char> rom);
+
+		static std::optional<int> snesToPc(int snes_address, Mapper mapper);
+		static std::optional<int> pcToSnes(int pc_offset, Mapper mapper);
+
+		Mapper getMapper() const;
+		size_t getSize() const;
+
+		std::optional<int> snesToPc(int snes_address) const;
+		std::optional<int> pcToSnes(int pc_offset) const;
+
+		// Reads by SNES address, throw if the bytes don't map to the ROM
+		uint8_t read1(int snes_address) const;
+		uint16_t read2(int snes_address) const;
+		uint32_t read3(int snes_address) const;
+
+		std::span<const char> view(size_t pc_offset, size_t size) const;
+	};
+}
@@ -34,117 +34,41 @@ namespace callisto {
 		return fmt::format("org ${:06X}\ndb \"{}\"", COMMENT_ADDRESS, getMarkerString(extractables, timestamp));
 	}
 
-	std::string Marker::getMarkerCheckPatch() {
-		std::ostringstream patch{};
-
-		patch << "!marker_present = 1" << std::endl;
-
-		uint8_t byte;
-		int i{ 0 };
-		while ((byte = CALLISTO_STRING[i]) != '\0') {
-			patch << fmt::format(
-				"if read1(${:06X}) != ${:02X}\n!marker_present = 0\nendif\n",
-				CALLISTO_STRING_LOCATION + i++, static_cast<int>(byte)
-			);
-		}
-		patch << fmt::format("if !marker_present\n"
-			"print hex(read2(${:06X}))\n"
-			"print hex(read2(${:06X}))\n"
-			"print hex(read3(${:06X}))\n"
-			"endif", BITFIELD_LOCATION, TIMESTAMP_LOCATION, TIMESTAMP_LOCATION + 2);
-		return patch.str();
-	}
-
 	std::optional<Marker::Extracted> Marker::extractInformation(const fs::path& rom_path) {
-		std::ifstream rom_file(rom_path, std::ios::in | std::ios::binary);
-		std::vector<char> rom_bytes((std::istreambuf_iterator<char>(rom_file)), (std::istreambuf_iterator<char>()));
-		rom_file.close();
-
-		int rom_size{ static_cast<int>(rom_bytes.size()) };
-		const auto header_size{ rom_size & 0x7FFF };
-
-		int unheadered_rom_size{ rom_size - header_size };
-
-		const auto patch_string{ getMarkerCheckPatch() };
-
-		if (!asar_init()) {
-			spdlog::warn(fmt::format(colors::WARNING, "Failed to check ROM {} for marker string because asar not found", rom_path.string()));
-		}
-
-		asar_reset();
-
-		const auto prev_diretcory{ fs::current_path() };
-		fs::current_path(boost::filesystem::temp_directory_path().string());
-
-		memoryfile patch;
-		patch.path = "extractor.asm";
-		patch.buffer = patch_string.data();
-		patch.length = patch_string.size();
-
-		const patchparams params{
-			sizeof(struct patchparams),
-			"extractor.asm",
-			rom_bytes.data() + header_size,
-			MAX_ROM_SIZE,
-			&unheadered_rom_size,
-			nullptr,
-			0,
-			true,
-			nullptr,
-			0,
-			nullptr,
-			nullptr,
-			nullptr,
-			0,
-			&patch,
-			1,
-			true,
-			false
-		};
-
-		const bool succeeded{ asar_patch_ex(&params) };
+		const MappedRom mapped_rom{ rom_path };
+		return extractInformation(RomView(mapped_rom.getBody(), RomView::Mapper::LOROM), rom_path);
+	}
 
-		fs::current_path(prev_diretcory);
-		
-		if (succeeded) {
-			int print_count;
-			const auto prints{ asar_getprints(&print_count) };
-			if (print_count != 3) {
-				spdlog::debug("Failed to extract marker information from ROM {}", rom_path.string());
-				return {};
+	std::optional<Marker::Extracted> Marker::extractInformation(const RomView& rom, const fs::path& rom_path) {
+		try {
+			const std::string_view callisto_string{ CALLISTO_STRING };
+			for (size_t i{ 0 }; i != callisto_string.size(); ++i) {
+				if (rom.read1(CALLISTO_STRING_LOCATION + static_cast<int>(i)) != static_cast<uint8_t>(callisto_string[i])) {
+					spdlog::debug("No marker found in ROM {}", rom_path.string());
+					return {};
+				}
 			}
-			else {
-				uint16_t bits;
 
-				std::stringstream temp;
-				temp << std::hex << prints[0];
-				temp >> bits;
+			const uint16_t bits{ rom.read2(BITFIELD_LOCATION) };
+			const uint64_t timestamp{ (static_cast<uint64_t>(rom.read2(TIMESTAMP_LOCATION)) << 24) | rom.read3(TIMESTAMP_LOCATION + 2) };
 
-				uint64_t timestamp;
-				temp.clear();
-				temp << fmt::format("{:04X}{:06X}", std::stoi(prints[1], nullptr, 16), std::stoi(prints[2], nullptr, 16));
-				temp >> timestamp;
-
-				spdlog::debug("Marker found in ROM {}, bitfield is 0x{:04X}, timestamp is 0x{:010X}", rom_path.string(), bits, timestamp);
-				return Extracted(bits, timestamp);
-			}
+			spdlog::debug("Marker found in ROM {}, bitfield is 0x{:04X}, timestamp is 0x{:010X}", rom_path.string(), bits, timestamp);
+			return Extracted(bits, timestamp);
 		}
-		else {
-			spdlog::warn(fmt::format(colors::WARNING, "Failed to check ROM {} for marker string", rom_path.string()));
+		catch (const CallistoException&) {
+			spdlog::debug("ROM {} is too small to contain a marker", rom_path.string());
 			return {};
 		}
 	}
 
 	void Marker::insertMarkerString(const fs::path& rom_path, const std::vector<ExtractableType>& extractables, int64_t timestamp) {
-		std::ifstream rom_file(rom_path, std::ios::in | std::ios::binary);
-		std::vector<char> rom_bytes((std::istreambuf_iterator<char>(rom_file)), (std::istreambuf_iterator<char>()));
-		rom_file.close();
-
-		int rom_size{ static_cast<int>(rom_bytes.size()) };
-		const auto header_size{ rom_size & 0x7FFF };
-
-		int unheadered_rom_size{ rom_size - header_size };
+		RomImage rom_image{ rom_path };
+		insertMarkerString(rom_image, extractables, timestamp);
+		rom_image.flush();
+	}
 
+	void Marker::insertMarkerString(RomImage& rom_image, const std::vector<ExtractableType>& extractables, int64_t timestamp) {
+		const auto& rom_path{ rom_image.getPath() };
 		const auto patch_string{ getMarkerInsertionPatch(extractables, timestamp) };
 
 		if (!asar_init()) {
@@ -161,11 +85,14 @@ namespace callisto {
 		patch.buffer = patch_string.data();
 		patch.length = patch_string.size();
 
+		int unheadered_rom_size{ static_cast<int>(rom_image.getSize()) };
+		const auto rom_size{ unheadered_rom_size };
+
 		const patchparams params{
 			sizeof(struct patchparams),
 			"inserter.asm",
-			rom_bytes.data() + header_size,
-			MAX_ROM_SIZE,
+			rom_image.beginPatching(),
+			AssemblyBufferPool::BUFFER_SIZE,
 			&unheadered_rom_size,
 			nullptr,
 			0,
@@ -187,13 +114,11 @@ namespace callisto {
 		fs::current_path(prev_directory);
 
 		if (succeeded) {
+			rom_image.finishPatching(unheadered_rom_size, true);
 			spdlog::debug("Successfully inserted marker string into ROM {}", rom_path.string());
-
-			std::ofstream out_rom{ rom_path, std::ios::out | std::ios::binary };
-			out_rom.write(rom_bytes.data(), rom_bytes.size());
-			out_rom.close();
 		}
 		else {
+			rom_image.finishPatching(rom_size, false);
 			spdlog::warn(fmt::format(colors::WARNING, "Failed to insert marker string into ROM {}", rom_path.string()));
 		}
 	}
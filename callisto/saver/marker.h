@@ -4,7 +4,7 @@
 #include <filesystem>
 #include <fstream>
 #include <optional>
-#include <sstream>
+#include <string_view>
 
 #include <spdlog/spdlog.h>
 #include <fmt/format.h>
@@ -14,6 +14,9 @@
 
 #include "extractable_type.h"
 #include "../path_util.h"
+#include "../rom/rom_image.h"
+#include "../rom/rom_view.h"
+#include "../rom/mapped_rom.h"
 
 #include "../colors.h"
 
@@ -23,7 +26,6 @@ namespace fs = std::filesystem;
 namespace callisto {
 	class Marker {
 	protected:
-		static constexpr auto MAX_ROM_SIZE = 16 * 1024 * 1024;
 		static constexpr auto COMMENT_ADDRESS = 0xFF0B8;
 
 		static constexpr auto CALLISTO_STRING = "-~*callisto*~-";
@@ -55,12 +57,13 @@ namespace callisto {
 		static std::string getMarkerString(const std::vector<ExtractableType>& extractables, int64_t timestamp);
 
 		static std::string getMarkerInsertionPatch(const std::vector<ExtractableType>& extractables, int64_t timestamp);
-		static std::string getMarkerCheckPatch();
 
 		static std::optional<Extracted> extractInformation(const fs::path& rom_path);
+		static std::optional<Extracted> extractInformation(const RomView& rom, const fs::path& rom_path);
 
 	public:
 		static void insertMarkerString(const fs::path& rom_path, const std::vector<ExtractableType>& extractables, int64_t timestamp);
+		static void insertMarkerString(RomImage& rom_image, const std::vector<ExtractableType>& extractables, int64_t timestamp);
 		static std::vector<ExtractableType> getNeededExtractions(const fs::path& rom_path, const fs::path& project_root,
 			const std::vector<ExtractableType>& extractables, bool use_text_map16);
 	};
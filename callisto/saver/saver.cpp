@@ -111,7 +111,8 @@ namespace callisto {
 		return extractables;
 	}
 
-	void Saver::updateBuildReport(const fs::path& build_report, const std::vector<ExtractableType>& extracted_types) {
+	void Saver::updateBuildReport(const fs::path& project_root, const std::vector<ExtractableType>& extracted_types) {
+		const auto build_report{ PathUtil::getBuildReportPath(project_root) };
 		std::ifstream file{ build_report };
 		json j{ json::parse(file) };
 
@@ -121,10 +122,10 @@ namespace callisto {
 		}
 
 		for (auto& entry : j["dependencies"]) {
-			Descriptor descriptor{ entry["descriptor"] };
+			Descriptor descriptor{ entry["descriptor"], project_root };
 			if (extracted_symbols.find(descriptor.symbol) != extracted_symbols.end()) {
 				for (auto& json_resource_dependency : entry["resource_dependencies"]) {
-					ResourceDependency dependency{ json_resource_dependency };
+					ResourceDependency dependency{ json_resource_dependency, project_root };
 					ResourceDependency new_dependency{ dependency.dependent_path, dependency.policy };
 					if (new_dependency.last_write_time.has_value()) {
 						json_resource_dependency["timestamp"] = new_dependency.last_write_time.value();
@@ -142,12 +143,21 @@ namespace callisto {
 	}
 
 	void Saver::writeMarkerToRom(const fs::path& rom_path, const Configuration& config) {
-		const auto now{ fs::last_write_time(rom_path) };
+		RomImage rom_image{ rom_path };
+		writeMarkerToRom(rom_image, config);
+	}
+
+	void Saver::writeMarkerToRom(RomImage& rom_image, const Configuration& config) {
+		const auto& rom_path{ rom_image.getPath() };
+
+		// the file is written right below anyway, so its write time will be now
+		const auto now{ std::chrono::file_clock::now() };
 		auto timestamp{ std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count() };
 		const auto now_as_seconds{ std::chrono::time_point<std::chrono::file_clock>(std::chrono::seconds(timestamp)) };
 		spdlog::debug("Marker timestamp is {:010X}", timestamp);
 
-		Marker::insertMarkerString(rom_path, getExtractableTypes(config), timestamp);
+		Marker::insertMarkerString(rom_image, getExtractableTypes(config), timestamp);
+		rom_image.flush();
 
 		fs::last_write_time(rom_path, now_as_seconds);
 
@@ -217,7 +227,7 @@ namespace callisto {
 				if (fs::exists(potential_build_report)) {
 					spdlog::info(fmt::format(colors::CALLISTO, "Found a build report, updating it now"));
 					try {
-						updateBuildReport(potential_build_report, need_extraction);
+						updateBuildReport(config.project_root.getOrThrow(), need_extraction);
 						spdlog::info(fmt::format(colors::PARTIAL_SUCCESS, "Successfully updated build report!\n"));
 					}
 					catch (const std::exception& e) {
@@ -48,11 +48,12 @@ namespace callisto {
 			const Configuration& config, ExtractableType type, const fs::path& extracting_rom);
 		static std::vector<std::shared_ptr<Extractable>> getExtractables(const Configuration& config, 
 			const std::vector<ExtractableType>& extractable_types, const fs::path& extracting_rom);
-		static void updateBuildReport(const fs::path& build_report, const std::vector<ExtractableType>& extracted_types);
+		static void updateBuildReport(const fs::path& project_root, const std::vector<ExtractableType>& extracted_types);
 
 	public:
 		static std::vector<ExtractableType> getExtractableTypes(const Configuration& config);
 		static void writeMarkerToRom(const fs::path& rom_path, const Configuration& config);
+		static void writeMarkerToRom(RomImage& rom_image, const Configuration& config);
 		static void exportResources(const fs::path& rom_path, const Configuration& config, bool force = false, bool mark = true);
 	};
 }
@@ -0,0 +1,97 @@
+#include <cstdlib>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <filesystem>
+
+#include "../cache/git_object_id.h"
+#include "../dependency/resource_dependency.h"
+
+using namespace callisto;
+namespace fs = std::filesystem;
+
+namespace {
+	// ctest reports tests exiting with this as skipped
+	constexpr int SKIPPED{ 77 };
+
+	int failures{ 0 };
+
+	void check(bool condition, const std::string& description) {
+		if (!condition) {
+			std::cerr << "FAILED: " << description << '\n';
+			++failures;
+		}
+	}
+
+	void writeFile(const fs::path& path, const std::string& contents) {
+		std::ofstream file{ path, std::ios::out | std::ios::binary };
+		file << contents;
+	}
+
+	void testObjectIds() {
+		check(GitObjectId::ofBlob(std::string("hello"), GitObjectId::SHA1_SIZE) == "b6fc4c620b67d95f953a5c1c1230aaab5db5a1b0",
+			"SHA-1 blob id matches git's");
+		check(GitObjectId::ofBlob(std::string("hello"), GitObjectId::SHA256_SIZE) ==
+			"8aec4e4876f854f688d0ebfc8f37598f38e5fd6903cccc850ca36591175aeb60", "SHA-256 blob id matches git's");
+		check(GitObjectId::ofBlob(std::string(), GitObjectId::SHA1_SIZE) == "e69de29bb2d1d6434b8b29ae775ad8c2e48c5391",
+			"blob id of an empty file matches git's");
+	}
+
+	// A tracked file that is touched without changing keeps its recorded blob id, but git no longer considers it clean
+	bool testTouchedTrackedFile(const fs::path& work_tree) {
+		const auto path{ work_tree / "level.asm" };
+		writeFile(path, "lda #$01\nsta $19\nrts\n");
+		// well before the index is written, so git doesn't consider the entry racily clean
+		fs::last_write_time(path, fs::last_write_time(path) - std::chrono::seconds(10));
+
+		const auto git{ fmt::format("git -C \"{}\"", work_tree.string()) };
+		if (std::system((git + " init -q && " + git + " add level.asm").c_str()) != 0) {
+			return false;
+		}
+
+		const json recorded_json = ResourceDependency(path, Policy::REINSERT).toJson(work_tree);
+		check(!recorded_json["git_blob"].is_null(), "clean tracked file is recorded with its blob id");
+		check(recorded_json["hash"].is_null(), "clean tracked file isn't hashed");
+
+		fs::last_write_time(path, fs::file_time_type::clock::now());
+		const ResourceDependency recorded{ recorded_json, work_tree };
+		const ResourceDependency touched{ path, Policy::REINSERT };
+		check(!recorded.hasSameStamp(), "touched file has a new stamp");
+		check(!GitIndex::getCleanBlobId(path).has_value(), "git doesn't consider the touched file clean");
+		check(recorded.hasSameContents(touched), "touched but identical tracked file has the same contents");
+
+		writeFile(path, "lda #$02\nsta $19\nrts\n");
+		fs::last_write_time(path, fs::file_time_type::clock::now() + std::chrono::seconds(10));
+		const ResourceDependency modified{ path, Policy::REINSERT };
+		check(!recorded.hasSameContents(modified), "modified tracked file doesn't have the same contents");
+
+		writeFile(path, "lda #$01\r\nsta $19\r\nrts\r\n");
+		fs::last_write_time(path, fs::file_time_type::clock::now() + std::chrono::seconds(20));
+		const ResourceDependency converted{ path, Policy::REINSERT };
+		check(recorded.hasSameContents(converted), "checkout with CRLF line endings has the same contents");
+
+		return true;
+	}
+}
+
+int main() {
+	testObjectIds();
+
+	const auto work_tree{ fs::temp_directory_path() / "callisto_resource_dependency_test" };
+	fs::remove_all(work_tree);
+	fs::create_directories(work_tree);
+	const auto ran_git_tests{ testTouchedTrackedFile(work_tree) };
+	fs::remove_all(work_tree);
+
+	if (failures != 0) {
+		std::cerr << failures << " check(s) failed\n";
+		return 1;
+	}
+	if (!ran_git_tests) {
+		std::cout << "git isn't available, skipped the tests on tracked files\n";
+		return SKIPPED;
+	}
+	std::cout << "All checks passed\n";
+	return 0;
+}
@@ -0,0 +1,178 @@
+#include <cstdint>
+#include <vector>
+#include <span>
+#include <string>
+#include <functional>
+#include <iostream>
+
+#include <boost/crc.hpp>
+
+#include "../rom/bps_patch.h"
+#include "../rom/rom_merge.h"
+
+using namespace callisto;
+
+namespace {
+	constexpr size_t CLEAN_ROM_SIZE{ 0x80000 };
+	constexpr size_t EXPANDED_ROM_SIZE{ 0x100000 };
+
+	int failures{ 0 };
+
+	void check(bool condition, const std::string& description) {
+		if (!condition) {
+			std::cerr << "FAILED: " << description << '\n';
+			++failures;
+		}
+	}
+
+	void writeNumber(std::vector<char>& out, uint64_t number) {
+		while (true) {
+			const auto low_bits{ static_cast<char>(number & 0x7F) };
+			number >>= 7;
+			if (number == 0) {
+				out.push_back(static_cast<char>(0x80 | low_bits));
+				return;
+			}
+			out.push_back(low_bits);
+			--number;
+		}
+	}
+
+	void writeChecksum(std::vector<char>& out, std::span<const char> bytes) {
+		boost::crc_32_type crc{};
+		crc.process_bytes(bytes.data(), bytes.size());
+		const auto checksum{ crc.checksum() };
+		for (int shift{ 0 }; shift != 32; shift += 8) {
+			out.push_back(static_cast<char>((checksum >> shift) & 0xFF));
+		}
+	}
+
+	// A BPS patch that reads the whole target from the patch, like FLIPS would make for an expanded ROM
+	std::vector<char> makeBpsPatch(std::span<const char> source, std::span<const char> target) {
+		std::vector<char> patch{ 'B', 'P', 'S', '1' };
+		writeNumber(patch, source.size());
+		writeNumber(patch, target.size());
+		writeNumber(patch, 0);
+		writeNumber(patch, ((target.size() - 1) << 2) | 1);
+		patch.insert(patch.end(), target.begin(), target.end());
+		writeChecksum(patch, source);
+		writeChecksum(patch, target);
+		writeChecksum(patch, patch);
+		return patch;
+	}
+
+	std::vector<char> makeCleanRom() {
+		std::vector<char> clean(CLEAN_ROM_SIZE);
+		for (size_t i{ 0 }; i != clean.size(); ++i) {
+			clean[i] = static_cast<char>(i * 7 + (i >> 8));
+		}
+		return clean;
+	}
+
+	std::vector<char> expand(const std::vector<char>& rom, size_t size, char filler) {
+		auto expanded{ rom };
+		expanded.resize(size, filler);
+		return expanded;
+	}
+
+	void place(std::vector<char>& rom, size_t pc_offset, const std::string& data) {
+		std::copy(data.begin(), data.end(), rom.begin() + pc_offset);
+	}
+
+	bool contains(const std::vector<char>& rom, size_t pc_offset, const std::string& data) {
+		return std::equal(data.begin(), data.end(), rom.begin() + pc_offset);
+	}
+
+	bool conflicts(const std::function<void()>& merge) {
+		try {
+			merge();
+			return false;
+		}
+		catch (const RomMerge::Conflict&) {
+			return true;
+		}
+	}
+
+	void testDisjointChanges() {
+		const auto clean{ makeCleanRom() };
+		auto patched{ clean };
+		auto graphics{ clean };
+		place(patched, 0x1000, "patch");
+		place(graphics, 0x2000, "graphics");
+
+		const auto merged{ RomMerge::threeWay(clean, patched, graphics) };
+		check(merged.size() == CLEAN_ROM_SIZE, "merge of unexpanded ROMs keeps their size");
+		check(contains(merged, 0x1000, "patch") && contains(merged, 0x2000, "graphics"), "disjoint changes are both kept");
+	}
+
+	void testConflictingChanges() {
+		const auto clean{ makeCleanRom() };
+		auto patched{ clean };
+		auto graphics{ clean };
+		place(patched, 0x1000, "patch");
+		place(graphics, 0x1000, "graphics");
+
+		check(conflicts([&] { RomMerge::threeWay(clean, patched, graphics); }), "different changes to the same bytes conflict");
+	}
+
+	void testExpandedPatch() {
+		const auto clean{ makeCleanRom() };
+
+		// both sides expanded, with different filler, and put their data in different places of the expanded area
+		auto target{ expand(clean, EXPANDED_ROM_SIZE, '\xFF') };
+		place(target, 0x100, "level pointer");
+		place(target, 0x90000, "STAR level data");
+		auto graphics{ expand(clean, EXPANDED_ROM_SIZE, '\x00') };
+		place(graphics, 0x200, "gfx pointer");
+		place(graphics, 0xA0000, "STAR exgfx");
+
+		const auto patch{ makeBpsPatch(clean, target) };
+		const auto patched{ BpsPatch::apply(clean, patch) };
+		check(patched == target, "expanded BPS patch applies");
+
+		std::vector<char> merged{};
+		check(!conflicts([&] { merged = RomMerge::threeWay(clean, patched, graphics); }),
+			"expanded ROMs with data in different places don't conflict");
+		check(merged.size() == EXPANDED_ROM_SIZE, "merge keeps the expanded size");
+		check(contains(merged, 0x100, "level pointer") && contains(merged, 0x200, "gfx pointer"),
+			"changes to the clean ROM's area are merged");
+		check(contains(merged, 0x90000, "STAR level data") && contains(merged, 0xA0000, "STAR exgfx"),
+			"data in the expanded area is merged");
+		check(merged[0xB0000] == '\xFF', "untouched expanded area keeps the patch's filler");
+
+		// data overlapping in the expanded area still conflicts
+		auto overlapping_graphics{ expand(clean, EXPANDED_ROM_SIZE, '\x00') };
+		place(overlapping_graphics, 0x90000, "STAR exgfx");
+		check(conflicts([&] { RomMerge::threeWay(clean, patched, overlapping_graphics); }),
+			"overlapping data in the expanded area conflicts");
+	}
+
+	void testPatchExpandedFurther() {
+		const auto clean{ makeCleanRom() };
+		auto patched{ expand(clean, 2 * EXPANDED_ROM_SIZE, '\xFF') };
+		place(patched, 0x180000, "STAR far data");
+		auto graphics{ expand(clean, EXPANDED_ROM_SIZE, '\x00') };
+		place(graphics, 0x90000, "STAR exgfx");
+
+		std::vector<char> merged{};
+		check(!conflicts([&] { merged = RomMerge::threeWay(clean, patched, graphics); }),
+			"differently expanded ROMs don't conflict");
+		check(merged.size() == 2 * EXPANDED_ROM_SIZE, "merge takes the larger size");
+		check(contains(merged, 0x90000, "STAR exgfx") && contains(merged, 0x180000, "STAR far data"),
+			"data from both sides is merged");
+	}
+}
+
+int main() {
+	testDisjointChanges();
+	testConflictingChanges();
+	testExpandedPatch();
+	testPatchExpandedFurther();
+
+	if (failures != 0) {
+		std::cerr << failures << " check(s) failed\n";
+		return 1;
+	}
+	std::cout << "All checks passed\n";
+	return 0;
+}